@@ -1,9 +1,10 @@
 ﻿#include "BlackholeApp.h"
 #include "LightRay.h"
 #include "LightFieldGrid.h"
+#include "LightFieldView.h"
 #include <iostream>
 #include <cmath>
-#include <random>
+#include <algorithm>
 
 // Define PI if not already defined
 #ifndef M_PI
@@ -37,30 +38,47 @@ void main() {
 }
 )";
 
-// Grid vertex shader - positions and colors
+// Grid vertex shader - one quad over the whole grid
 const char* BlackholeApp::gridVertexShaderSource = R"(
 #version 330 core
-layout (location = 0) in vec2 aPos;
-layout (location = 1) in vec3 aColor;
+layout (location = 0) in vec2 aPos;    // Quad corner (0..1)
 
 uniform mat4 u_Projection;
+uniform vec2 u_GridOrigin;
+uniform float u_GridExtent;
 
-out vec3 vertexColor;
+out vec2 gridCoord;
 
 void main() {
-    gl_Position = u_Projection * vec4(aPos, 0.0, 1.0);
-    vertexColor = aColor;
+    vec2 worldPos = u_GridOrigin + aPos * u_GridExtent;
+    gl_Position = u_Projection * vec4(worldPos, 0.0, 1.0);
+    gridCoord = aPos;
 }
 )";
 
-// Grid fragment shader - uses vertex colors
+// Grid fragment shader - looks the cell intensity up in the colormap
+// (the palette spans [threshold, max brightness]; cells below the threshold stay black)
 const char* BlackholeApp::gridFragmentShaderSource = R"(
 #version 330 core
-in vec3 vertexColor;
+in vec2 gridCoord;
 out vec4 FragColor;
 
+uniform sampler2D u_Intensity;
+uniform sampler1D u_Palette;
+uniform float u_DisplayThreshold;
+uniform float u_MaxBrightness;
+
 void main() {
-    FragColor = vec4(vertexColor, 1.0);
+    float intensity = texture(u_Intensity, gridCoord).r;
+    if (intensity < u_DisplayThreshold) {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // Position in the ramp, mapped onto entry centres so both end entries are reached exactly
+    float t = clamp((intensity - u_DisplayThreshold) / (u_MaxBrightness - u_DisplayThreshold), 0.0, 1.0);
+    float entries = float(textureSize(u_Palette, 0));
+    FragColor = vec4(texture(u_Palette, (t * (entries - 1.0) + 0.5) / entries).rgb, 1.0);
 }
 )";
 
@@ -71,19 +89,33 @@ BlackholeApp::BlackholeApp(int width, int height)
   , shaderProgram(0)
   , gridShaderProgram(0)
   , lineVAO(0)
-  , lineVBO(0)
   , blackholePos(0.0f, 0.0f)  // ALWAYS centered at origin
   , blackholeRadius(0.288f)    // Your preferred radius
   , blackholeMass(0.22f)       // Your preferred mass
+  , drawnBlackholeRadius(0.288f)
+  , rays(TRAIL_CAPACITY)
+  , randomSeed(RayBatch::DEFAULT_SEED)
+  , workers(0)                 // One thread per core
+  , stepDeltaTime(0.0f)
+  , stepAlpha(0.0f)
+  , stepDisplay(nullptr)
+  , useTrajectoryCache(true)
+  , useCapturePrediction(true)
+  , useBinnedAccumulation(true)
+  , paletteIndex(0)
   , time(0.0f)
   , raySpeed(0.795f)           // Updated default speed
-  , zoomLevel(1.0f) {          // Default zoom level
+  , zoomLevel(1.0f)            // Default zoom level
+  , cullRadius(CULL_DISTANCE)
+  , pendingFrameTime(0.0f) {
   g_App = this;  // Set global pointer for callback
 }
 
 BlackholeApp::~BlackholeApp() {
+  StopSimulation();
   if (lineVAO) glDeleteVertexArrays(1, &lineVAO);
-  if (lineVBO) glDeleteBuffers(1, &lineVBO);
+  overlayStream.reset();
+  lightFieldView.reset();  // Its GL objects go while the context is still current
   if (shaderProgram) glDeleteProgram(shaderProgram);
   if (gridShaderProgram) glDeleteProgram(gridShaderProgram);
   if (window) {
@@ -150,11 +182,13 @@ bool BlackholeApp::Initialize() {
   }
 
   // Initialize light field grid
-  lightField = std::make_unique<LightFieldGrid>();
-  if (!lightField->Initialize()) {
+  lightField = std::make_unique<LightFieldGrid>(LIGHT_FIELD_RESOLUTION, LIGHT_FIELD_SPARSE);
+  lightFieldView = std::make_unique<LightFieldView>(lightField->GetResolution(), lightField->GetWorldSize());
+  if (!lightFieldView->Initialize()) {
     std::cerr << "Failed to initialize light field grid" << std::endl;
     return false;
   }
+  lightField->SetShardCount(useBinnedAccumulation ? 0 : workers.GetThreadCount());
 
   // Initialize light rays
   InitRays();
@@ -162,6 +196,19 @@ bool BlackholeApp::Initialize() {
   // Set up initial projection matrix
   UpdateProjectionMatrix();
 
+  // Start the simulation thread; from here on it owns the rays and the grid data
+  GridFrame frame;
+  frame.intensity.assign(lightField->GetDisplayDataSize(), 0.0f);
+  frame.tileChanges = lightField->GetTileChangeFrames();
+  frame.tileVisible = lightField->GetTileVisible();
+  frame.displayFrame = 0;
+  frame.displayThreshold = lightField->GetDisplayThreshold();
+  frame.maxBrightness = lightField->GetMaxBrightness();
+  frame.blackholeRadius = blackholeRadius;
+  gridFrames.Fill(frame);
+  drawnBlackholeRadius = blackholeRadius;
+  simThread = std::thread(&BlackholeApp::SimulationLoop, this);
+
   // Enable blending for transparency
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -213,15 +260,13 @@ bool BlackholeApp::InitShaders() {
 }
 
 bool BlackholeApp::InitGeometry() {
-  // Create VAO and VBO for line/circle drawing
+  // Create VAO for line/circle drawing, fed from a streaming buffer
   glGenVertexArrays(1, &lineVAO);
-  glGenBuffers(1, &lineVBO);
-
   glBindVertexArray(lineVAO);
-  glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
 
-  // Pre-allocate buffer for circle drawing
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 1000 * 2, nullptr, GL_DYNAMIC_DRAW);
+  // Room for 1000 vertices per frame
+  overlayStream = std::make_unique<StreamBuffer>();
+  if (!overlayStream->Initialize(GL_ARRAY_BUFFER, sizeof(float) * 1000 * 2)) return false;
 
   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
   glEnableVertexAttribArray(0);
@@ -234,109 +279,116 @@ bool BlackholeApp::InitGeometry() {
 
 // InitRays() for parallel beams from 4 directions with more randomization
 void BlackholeApp::InitRays() {
-  rays.clear();
+  rays.Clear();
+  rays.Reserve(NUM_RAYS);
 
-  // Random number generation for variations
-  std::random_device rd;
-  std::mt19937 gen(rd());
+  // Random variations come from counter-based draws keyed by (seed, ray index),
+  // so the same seed always produces the same rays
+  rays.SetSeed(randomSeed);
+  auto draw = [this](int index) {
+    return Philox4x32(static_cast<uint32_t>(index), 0, RANDOM_STREAM_SPAWN, 0, randomSeed);
+  };
 
   // Increased noise ranges for more variation
-  std::uniform_real_distribution<float> posNoise(-0.1f, 0.1f);      // Larger position variation
-  std::uniform_real_distribution<float> angleNoise(-0.1f, 0.1f);  // Larger angle variation
-  std::uniform_real_distribution<float> speedNoise(0.8f, 1.2f);     // Wider speed variation
-  std::uniform_real_distribution<float> offsetNoise(-0.1f, 0.1f); // Additional perpendicular offset
+  const float posNoise = 0.1f;     // Larger position variation
+  const float angleNoise = 0.1f;   // Larger angle variation
+  const float offsetNoise = 0.1f;  // Additional perpendicular offset
 
   int raysPerDirection = NUM_RAYS / 4;  // Divide rays among 4 directions
 
   // 1. LEFT TO RIGHT rays
   for (int i = 0; i < raysPerDirection; i++) {
+    RandomBlock noise = draw(i);
     float spacing = 4.0f / raysPerDirection;
     float baseY = -2.0f + spacing * i;
-    float y = baseY + posNoise(gen);
-    float x = -2.0f + offsetNoise(gen);  // Add slight offset from edge
-
-    rays.push_back(std::make_unique<LightRay>(
-      glm::vec2(x, y),                      // Starting position with noise
-      raySpeed * speedNoise(gen),           // Speed with variation
-      500,                                   // Segment count
-      0.0f + angleNoise(gen)                // Angle: 0 = straight right, with noise
-    ));
+    float y = baseY + noise.Uniform(0, -posNoise, posNoise);
+    float x = -2.0f + noise.Uniform(1, -offsetNoise, offsetNoise);  // Add slight offset from edge
+
+    rays.AddRay(
+      glm::vec2(x, y),                              // Starting position with noise
+      raySpeed * noise.Uniform(2, 0.8f, 1.2f),      // Speed with variation
+      0.0f + noise.Uniform(3, -angleNoise, angleNoise)  // Angle: 0 = straight right, with noise
+    );
   }
 
   // 2. RIGHT TO LEFT rays
   for (int i = 0; i < raysPerDirection; i++) {
+    RandomBlock noise = draw(raysPerDirection + i);
     float spacing = 4.0f / raysPerDirection;
     float baseY = -2.0f + spacing * i;
-    float y = baseY + posNoise(gen);
-    float x = 2.0f + offsetNoise(gen);  // Add slight offset from edge
-
-    rays.push_back(std::make_unique<LightRay>(
-      glm::vec2(x, y),                      // Starting position with noise
-      raySpeed * speedNoise(gen),           // Speed with variation
-      500,                                   // Segment count
-      M_PI + angleNoise(gen)                // Angle: π = straight left, with noise
-    ));
+    float y = baseY + noise.Uniform(0, -posNoise, posNoise);
+    float x = 2.0f + noise.Uniform(1, -offsetNoise, offsetNoise);  // Add slight offset from edge
+
+    rays.AddRay(
+      glm::vec2(x, y),                              // Starting position with noise
+      raySpeed * noise.Uniform(2, 0.8f, 1.2f),      // Speed with variation
+      M_PI + noise.Uniform(3, -angleNoise, angleNoise)  // Angle: π = straight left, with noise
+    );
   }
 
   // 3. TOP TO BOTTOM rays
   for (int i = 0; i < raysPerDirection; i++) {
+    RandomBlock noise = draw(2 * raysPerDirection + i);
     float spacing = 4.0f / raysPerDirection;
     float baseX = -2.0f + spacing * i;
-    float x = baseX + posNoise(gen);
-    float y = 2.0f + offsetNoise(gen);  // Add slight offset from edge
-
-    rays.push_back(std::make_unique<LightRay>(
-      glm::vec2(x, y),                       // Starting position with noise
-      raySpeed * speedNoise(gen),            // Speed with variation
-      500,                                    // Segment count
-      -M_PI / 2.0f + angleNoise(gen)        // Angle: -π/2 = straight down, with noise
-    ));
+    float x = baseX + noise.Uniform(0, -posNoise, posNoise);
+    float y = 2.0f + noise.Uniform(1, -offsetNoise, offsetNoise);  // Add slight offset from edge
+
+    rays.AddRay(
+      glm::vec2(x, y),                              // Starting position with noise
+      raySpeed * noise.Uniform(2, 0.8f, 1.2f),      // Speed with variation
+      -M_PI / 2.0f + noise.Uniform(3, -angleNoise, angleNoise)  // Angle: -π/2 = straight down, with noise
+    );
   }
 
   // 4. BOTTOM TO TOP rays
   for (int i = 0; i < raysPerDirection; i++) {
+    RandomBlock noise = draw(3 * raysPerDirection + i);
     float spacing = 4.0f / raysPerDirection;
     float baseX = -2.0f + spacing * i;
-    float x = baseX + posNoise(gen);
-    float y = -2.0f + offsetNoise(gen);  // Add slight offset from edge
-
-    rays.push_back(std::make_unique<LightRay>(
-      glm::vec2(x, y),                      // Starting position with noise
-      raySpeed * speedNoise(gen),           // Speed with variation
-      500,                                   // Segment count
-      M_PI / 2.0f + angleNoise(gen)         // Angle: π/2 = straight up, with noise
-    ));
+    float x = baseX + noise.Uniform(0, -posNoise, posNoise);
+    float y = -2.0f + noise.Uniform(1, -offsetNoise, offsetNoise);  // Add slight offset from edge
+
+    rays.AddRay(
+      glm::vec2(x, y),                              // Starting position with noise
+      raySpeed * noise.Uniform(2, 0.8f, 1.2f),      // Speed with variation
+      M_PI / 2.0f + noise.Uniform(3, -angleNoise, angleNoise)  // Angle: π/2 = straight up, with noise
+    );
   }
 
   std::cout << "Initialized " << NUM_RAYS << " rays with enhanced randomization" << std::endl;
-  std::cout << "Light field density visualization enabled" << std::endl;
+  std::cout << "Geodesic kernel: " << SimdLevelName(rays.GetSimdLevel())
+    << " (" << SimdLevelWidth(rays.GetSimdLevel()) << " rays per step)" << std::endl;
+  std::cout << "Light field density visualization enabled (" << lightField->GetResolution() << "x"
+    << lightField->GetResolution() << " cells)" << std::endl;
 }
 
 void BlackholeApp::DrawBlackhole() {
   const int segments = 128;
-  std::vector<float> circleVertices;
+  const int vertexCount = segments + 2;
 
-  circleVertices.push_back(blackholePos.x);
-  circleVertices.push_back(blackholePos.y);
+  // Write the fan straight into this frame's region of the overlay stream
+  float* circleVertices = static_cast<float*>(overlayStream->Map(vertexCount * 2 * sizeof(float)));
+  if (!circleVertices) return;
+
+  circleVertices[0] = blackholePos.x;
+  circleVertices[1] = blackholePos.y;
 
   for (int i = 0; i <= segments; i++) {
     float angle = 2.0f * M_PI * i / segments;
-    float x = blackholePos.x + blackholeRadius * cosf(angle);
-    float y = blackholePos.y + blackholeRadius * sinf(angle);
-    circleVertices.push_back(x);
-    circleVertices.push_back(y);
+    circleVertices[2 * i + 2] = blackholePos.x + drawnBlackholeRadius * cosf(angle);
+    circleVertices[2 * i + 3] = blackholePos.y + drawnBlackholeRadius * sinf(angle);
   }
 
+  // Regions hold whole vertices, so the region is selected by the first vertex index
+  GLint firstVertex = static_cast<GLint>(overlayStream->Unmap() / (2 * sizeof(float)));
+
   glUseProgram(shaderProgram);
   glBindVertexArray(lineVAO);
-  glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-
-  glBufferSubData(GL_ARRAY_BUFFER, 0,
-    circleVertices.size() * sizeof(float), circleVertices.data());
 
   // Draw filled black circle (fully opaque)
   glUniform4f(glGetUniformLocation(shaderProgram, "u_Color"), 0.0f, 0.0f, 0.0f, 1.0f);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, segments + 2);
+  glDrawArrays(GL_TRIANGLE_FAN, firstVertex, vertexCount);
 }
 
 void BlackholeApp::DrawRays() {
@@ -345,34 +397,48 @@ void BlackholeApp::DrawRays() {
   // This method is kept empty but could be used for debug visualization
 }
 
-void BlackholeApp::UpdateLightField() {
-  // Accumulate ray segments into the light field grid
-  for (const auto& ray : rays) {
-    // Skip absorbed rays
-    if (ray->IsAbsorbed()) {
-      continue;
-    }
+bool BlackholeApp::GetHeadSegment(size_t i, glm::vec2& start, glm::vec2& end) const {
+  // Skip absorbed rays and rays waiting to respawn
+  if (rays.IsAbsorbed(i) || rays.IsRespawnPending(i) || rays.IsMarkedForRespawn(i)) {
+    return false;
+  }
+
+  TrailView segments = rays.GetTrail(i);
+  if (segments.size() < 2) return false;
+
+  // Only accumulate the most recent segment (the ray head movement this frame)
+  // This represents where the photon traveled during this frame
+  size_t headIndex = 0; // Head is at the front of the segments vector
+  start = segments[headIndex];
+  end = segments[headIndex + 1];
+  return true;
+}
 
-    const auto& segments = ray->GetSegments();
-    if (segments.size() < 2) continue;
+void BlackholeApp::AccumulateRays(size_t slot, size_t begin, size_t end) {
+  float intensity = 0.1f; // Higher intensity since we're only counting one segment
+  glm::vec2 start, stop;
 
-    // Only accumulate the most recent segment (the ray head movement this frame)
-    // This represents where the photon traveled during this frame
-    float intensity = 0.1f; // Higher intensity since we're only counting one segment
+  if (useBinnedAccumulation) {
+    // Sort-middle: file the chunk's segments by tile; ResolveLightField draws them
+    size_t bin = begin / RAY_CHUNK;
+    for (size_t i = begin; i < end; i++) {
+      if (GetHeadSegment(i, start, stop)) lightField->BinRaySegment(bin, start, stop, intensity);
+    }
+    return;
+  }
 
-    // Get the head segment (most recent movement)
-    size_t headIndex = 0; // Head is at the front of the segments vector
-    lightField->AccumulateRaySegment(segments[headIndex], segments[headIndex + 1], intensity);
+  // Accumulate ray segments into this thread's private shard of the light field grid
+  for (size_t i = begin; i < end; i++) {
+    if (GetHeadSegment(i, start, stop)) {
+      lightField->AccumulateRaySegment(static_cast<int>(slot), start, stop, intensity);
+    }
   }
 }
 
-
 void BlackholeApp::UpdateRaySpeed(float newSpeed) {
   raySpeed = newSpeed;
   // Update speed for all existing rays
-  for (auto& ray : rays) {
-    ray->SetSpeed(newSpeed);
-  }
+  rays.SetSpeed(newSpeed);
 }
 
 void BlackholeApp::ProcessInput(GLFWwindow* window) {
@@ -382,84 +448,112 @@ void BlackholeApp::ProcessInput(GLFWwindow* window) {
 
   // Adjust mass with Q/E keys
   if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) {
-    blackholeMass = std::max(0.1f, blackholeMass - 0.01f);
-    std::cout << "Black hole mass decreased to: " << blackholeMass << std::endl;
+    Post([this] {
+      blackholeMass = std::max(0.1f, blackholeMass - 0.01f);
+      std::cout << "Black hole mass decreased to: " << blackholeMass << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
-    blackholeMass = std::min(5.0f, blackholeMass + 0.01f);
-    std::cout << "Black hole mass increased to: " << blackholeMass << std::endl;
+    Post([this] {
+      blackholeMass = std::min(5.0f, blackholeMass + 0.01f);
+      std::cout << "Black hole mass increased to: " << blackholeMass << std::endl;
+    });
   }
 
   // Gravity multiplier with D/F keys
   if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-    float currentMult = LightRay::GetGravityMultiplier();
-    LightRay::SetGravityMultiplier(std::max(0.1f, currentMult - 0.02f));
-    std::cout << "Gravity multiplier decreased to: " << LightRay::GetGravityMultiplier() << std::endl;
+    Post([this] {
+      float currentMult = LightRay::GetGravityMultiplier();
+      LightRay::SetGravityMultiplier(std::max(0.1f, currentMult - 0.02f));
+      std::cout << "Gravity multiplier decreased to: " << LightRay::GetGravityMultiplier() << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS) {
-    float currentMult = LightRay::GetGravityMultiplier();
-    LightRay::SetGravityMultiplier(std::min(3.0f, currentMult + 0.02f));
-    std::cout << "Gravity multiplier increased to: " << LightRay::GetGravityMultiplier() << std::endl;
+    Post([this] {
+      float currentMult = LightRay::GetGravityMultiplier();
+      LightRay::SetGravityMultiplier(std::min(3.0f, currentMult + 0.02f));
+      std::cout << "Gravity multiplier increased to: " << LightRay::GetGravityMultiplier() << std::endl;
+    });
   }
 
   // Max force cap with C/V keys
   if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
-    float currentMax = LightRay::GetMaxForce();
-    LightRay::SetMaxForce(std::max(1.0f, currentMax - 0.5f));
-    std::cout << "Max force cap decreased to: " << LightRay::GetMaxForce() << std::endl;
+    Post([this] {
+      float currentMax = LightRay::GetMaxForce();
+      LightRay::SetMaxForce(std::max(1.0f, currentMax - 0.5f));
+      std::cout << "Max force cap decreased to: " << LightRay::GetMaxForce() << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS) {
-    float currentMax = LightRay::GetMaxForce();
-    LightRay::SetMaxForce(std::min(50.0f, currentMax + 0.5f));
-    std::cout << "Max force cap increased to: " << LightRay::GetMaxForce() << std::endl;
+    Post([this] {
+      float currentMax = LightRay::GetMaxForce();
+      LightRay::SetMaxForce(std::min(50.0f, currentMax + 0.5f));
+      std::cout << "Max force cap increased to: " << LightRay::GetMaxForce() << std::endl;
+    });
   }
 
   // Force exponent with G/H keys
   if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS) {
-    float currentExp = LightRay::GetForceExponent();
-    LightRay::SetForceExponent(std::max(0.5f, currentExp - 0.05f));
-    std::cout << "Force exponent decreased to: " << LightRay::GetForceExponent()
-      << " (lower = stronger at distance)" << std::endl;
+    Post([this] {
+      float currentExp = LightRay::GetForceExponent();
+      LightRay::SetForceExponent(std::max(0.5f, currentExp - 0.05f));
+      std::cout << "Force exponent decreased to: " << LightRay::GetForceExponent()
+        << " (lower = stronger at distance)" << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS) {
-    float currentExp = LightRay::GetForceExponent();
-    LightRay::SetForceExponent(std::min(4.0f, currentExp + 0.05f));
-    std::cout << "Force exponent increased to: " << LightRay::GetForceExponent()
-      << " (higher = weaker at distance)" << std::endl;
+    Post([this] {
+      float currentExp = LightRay::GetForceExponent();
+      LightRay::SetForceExponent(std::min(4.0f, currentExp + 0.05f));
+      std::cout << "Force exponent increased to: " << LightRay::GetForceExponent()
+        << " (higher = weaker at distance)" << std::endl;
+    });
   }
 
   // Adjust black hole radius with Z/X keys
   if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS) {
-    blackholeRadius = std::max(0.05f, blackholeRadius - 0.002f);
-    std::cout << "Black hole radius decreased to: " << blackholeRadius << std::endl;
+    Post([this] {
+      blackholeRadius = std::max(0.05f, blackholeRadius - 0.002f);
+      std::cout << "Black hole radius decreased to: " << blackholeRadius << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS) {
-    blackholeRadius = std::min(0.3f, blackholeRadius + 0.002f);
-    std::cout << "Black hole radius increased to: " << blackholeRadius << std::endl;
+    Post([this] {
+      blackholeRadius = std::min(0.3f, blackholeRadius + 0.002f);
+      std::cout << "Black hole radius increased to: " << blackholeRadius << std::endl;
+    });
   }
 
   // Adjust light speed with A/S keys
   if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-    raySpeed = std::max(0.05f, raySpeed - 0.005f);
-    UpdateRaySpeed(raySpeed);
-    std::cout << "Light speed decreased to: " << raySpeed << std::endl;
+    Post([this] {
+      raySpeed = std::max(0.05f, raySpeed - 0.005f);
+      UpdateRaySpeed(raySpeed);
+      std::cout << "Light speed decreased to: " << raySpeed << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-    raySpeed = std::min(1.0f, raySpeed + 0.005f);
-    UpdateRaySpeed(raySpeed);
-    std::cout << "Light speed increased to: " << raySpeed << std::endl;
+    Post([this] {
+      raySpeed = std::min(1.0f, raySpeed + 0.005f);
+      UpdateRaySpeed(raySpeed);
+      std::cout << "Light speed increased to: " << raySpeed << std::endl;
+    });
   }
 
   // Adjust grid decay rate with N/M keys
   if (glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS) {
-    float currentDecay = lightField->GetDecayRate();
-    lightField->SetDecayRate(std::max(0.1f, currentDecay - 0.002f));
-    std::cout << "Grid decay rate decreased to: " << lightField->GetDecayRate() << std::endl;
+    Post([this] {
+      float currentDecay = lightField->GetDecayRate();
+      lightField->SetDecayRate(std::max(0.1f, currentDecay - 0.002f));
+      std::cout << "Grid decay rate decreased to: " << lightField->GetDecayRate() << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
-    float currentDecay = lightField->GetDecayRate();
-    lightField->SetDecayRate(std::min(0.999f, currentDecay + 0.002f));
-    std::cout << "Grid decay rate increased to: " << lightField->GetDecayRate() << std::endl;
+    Post([this] {
+      float currentDecay = lightField->GetDecayRate();
+      lightField->SetDecayRate(std::min(0.999f, currentDecay + 0.002f));
+      std::cout << "Grid decay rate increased to: " << lightField->GetDecayRate() << std::endl;
+    });
   }
 
   // Adjust zoom level with +/- keys
@@ -467,12 +561,14 @@ void BlackholeApp::ProcessInput(GLFWwindow* window) {
     glfwGetKey(window, GLFW_KEY_KP_ADD) == GLFW_PRESS) {
     zoomLevel = std::min(5.0f, zoomLevel + 0.02f);
     UpdateProjectionMatrix();
+    UpdateCullRadius();
     std::cout << "Zoom in: " << zoomLevel << "x" << std::endl;
   }
   if (glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS ||
     glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS) {
     zoomLevel = std::max(0.5f, zoomLevel - 0.02f);
     UpdateProjectionMatrix();
+    UpdateCullRadius();
     std::cout << "Zoom out: " << zoomLevel << "x" << std::endl;
   }
 
@@ -480,82 +576,454 @@ void BlackholeApp::ProcessInput(GLFWwindow* window) {
   if (glfwGetKey(window, GLFW_KEY_0) == GLFW_PRESS) {
     zoomLevel = 1.0f;
     UpdateProjectionMatrix();
+    UpdateCullRadius();
     std::cout << "Zoom reset to 1.0x" << std::endl;
   }
 
   // Adjust display threshold with J/K keys
   if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS) {
-    float currentThreshold = lightField->GetDisplayThreshold();
-    lightField->SetDisplayThreshold(std::max(0.0f, currentThreshold - 0.005f));
-    std::cout << "Display threshold decreased to: " << lightField->GetDisplayThreshold() << std::endl;
+    Post([this] {
+      float currentThreshold = lightField->GetDisplayThreshold();
+      lightField->SetDisplayThreshold(std::max(0.0f, currentThreshold - 0.005f));
+      std::cout << "Display threshold decreased to: " << lightField->GetDisplayThreshold() << std::endl;
+    });
   }
   if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) {
-    float currentThreshold = lightField->GetDisplayThreshold();
-    lightField->SetDisplayThreshold(std::min(0.5f, currentThreshold + 0.005f));
-    std::cout << "Display threshold increased to: " << lightField->GetDisplayThreshold() << std::endl;
+    Post([this] {
+      float currentThreshold = lightField->GetDisplayThreshold();
+      lightField->SetDisplayThreshold(std::min(0.5f, currentThreshold + 0.005f));
+      std::cout << "Display threshold increased to: " << lightField->GetDisplayThreshold() << std::endl;
+    });
+  }
+
+  // Weak-field switch radius with [/] keys
+  if (glfwGetKey(window, GLFW_KEY_LEFT_BRACKET) == GLFW_PRESS) {
+    Post([this] {
+      WeakFieldSettings settings = rays.GetWeakFieldSettings();
+      settings.switchRadius = std::max(0.3f, settings.switchRadius - 0.01f);
+      rays.SetWeakFieldSettings(settings);
+      std::cout << "Weak-field switch radius decreased to: " << settings.switchRadius << std::endl;
+    });
+  }
+  if (glfwGetKey(window, GLFW_KEY_RIGHT_BRACKET) == GLFW_PRESS) {
+    Post([this] {
+      WeakFieldSettings settings = rays.GetWeakFieldSettings();
+      settings.switchRadius = std::min(3.0f, settings.switchRadius + 0.01f);
+      rays.SetWeakFieldSettings(settings);
+      std::cout << "Weak-field switch radius increased to: " << settings.switchRadius << std::endl;
+    });
+  }
+
+  // Weak-field error bound with ,/. keys
+  if (glfwGetKey(window, GLFW_KEY_COMMA) == GLFW_PRESS) {
+    Post([this] {
+      WeakFieldSettings settings = rays.GetWeakFieldSettings();
+      settings.tolerance = std::max(1e-5f, settings.tolerance / 1.05f);
+      rays.SetWeakFieldSettings(settings);
+      std::cout << "Weak-field error bound decreased to: " << settings.tolerance << std::endl;
+    });
+  }
+  if (glfwGetKey(window, GLFW_KEY_PERIOD) == GLFW_PRESS) {
+    Post([this] {
+      WeakFieldSettings settings = rays.GetWeakFieldSettings();
+      settings.tolerance = std::min(1e-1f, settings.tolerance * 1.05f);
+      rays.SetWeakFieldSettings(settings);
+      std::cout << "Weak-field error bound increased to: " << settings.tolerance << std::endl;
+    });
   }
 
   // Reset with R key or SPACE bar
   if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS ||
     glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-    InitRays();
-    lightField->Clear();
-    std::cout << "Simulation reset (keeping current parameters)" << std::endl;
+    Post([this] {
+      // Recycle the existing rays through the respawn queue (spread over a few steps)
+      rays.RespawnAll();
+      lightField->Clear();
+      std::cout << "Simulation reset (keeping current parameters)" << std::endl;
+    });
+  }
+
+  // Toggle trajectory cache replay with T key (with debounce)
+  static bool tKeyWasPressed = false;
+  bool tKeyIsPressed = (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS);
+
+  if (tKeyIsPressed && !tKeyWasPressed) {
+    Post([this] {
+      useTrajectoryCache = !useTrajectoryCache;
+      std::cout << "Trajectory cache " << (useTrajectoryCache ? "enabled" : "disabled") << std::endl;
+    });
+  }
+
+  tKeyWasPressed = tKeyIsPressed;
+
+  // Toggle capture prediction with B key (with debounce)
+  static bool bKeyWasPressed = false;
+  bool bKeyIsPressed = (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS);
+
+  if (bKeyIsPressed && !bKeyWasPressed) {
+    Post([this] {
+      useCapturePrediction = !useCapturePrediction;
+      std::cout << "Capture prediction " << (useCapturePrediction ? "enabled" : "disabled") << std::endl;
+    });
+  }
+
+  bKeyWasPressed = bKeyIsPressed;
+
+  // Toggle the weak-field fast path with O key (with debounce)
+  static bool oKeyWasPressed = false;
+  bool oKeyIsPressed = (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS);
+
+  if (oKeyIsPressed && !oKeyWasPressed) {
+    Post([this] {
+      WeakFieldSettings settings = rays.GetWeakFieldSettings();
+      settings.enabled = !settings.enabled;
+      rays.SetWeakFieldSettings(settings);
+      std::cout << "Weak-field fast path " << (settings.enabled ? "enabled" : "disabled") << std::endl;
+    });
+  }
+
+  oKeyWasPressed = oKeyIsPressed;
+
+  // Cycle integration scheme with I key (with debounce)
+  static bool iKeyWasPressed = false;
+  bool iKeyIsPressed = (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS);
+
+  if (iKeyIsPressed && !iKeyWasPressed) {
+    Post([this] {
+      int next = (static_cast<int>(rays.GetIntegrator()) + 1) % INTEGRATOR_COUNT;
+      rays.SetIntegrator(static_cast<IntegratorType>(next));
+      std::cout << "Integrator: " << IntegratorName(rays.GetIntegrator()) << std::endl;
+    });
+  }
+
+  iKeyWasPressed = iKeyIsPressed;
+
+  // Toggle binned / sharded light field accumulation with L key (with debounce)
+  static bool lKeyWasPressed = false;
+  bool lKeyIsPressed = (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS);
+
+  if (lKeyIsPressed && !lKeyWasPressed) {
+    Post([this] {
+      useBinnedAccumulation = !useBinnedAccumulation;
+      lightField->SetShardCount(useBinnedAccumulation ? 0 : workers.GetThreadCount());
+      std::cout << "Light field accumulation: " << (useBinnedAccumulation ? "binned by tile" : "per-thread shards")
+        << std::endl;
+    });
   }
 
+  lKeyWasPressed = lKeyIsPressed;
+
+  // Toggle lazy light field decay with U key (with debounce)
+  static bool uKeyWasPressed = false;
+  bool uKeyIsPressed = (glfwGetKey(window, GLFW_KEY_U) == GLFW_PRESS);
+
+  if (uKeyIsPressed && !uKeyWasPressed) {
+    Post([this] {
+      lightField->SetLazyDecay(!lightField->IsLazyDecay());
+      std::cout << "Light field decay: " << (lightField->IsLazyDecay() ? "lazy (on write/display)" : "every step")
+        << std::endl;
+    });
+  }
+
+  uKeyWasPressed = uKeyIsPressed;
+
+  // Toggle path-length weighted light field deposits with Y key (with debounce)
+  static bool yKeyWasPressed = false;
+  bool yKeyIsPressed = (glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS);
+
+  if (yKeyIsPressed && !yKeyWasPressed) {
+    Post([this] {
+      lightField->SetPathLengthWeighting(!lightField->IsPathLengthWeighting());
+      std::cout << "Light field deposit: " << (lightField->IsPathLengthWeighting() ? "path length per cell" : "Bresenham")
+        << std::endl;
+    });
+  }
+
+  yKeyWasPressed = yKeyIsPressed;
+
+  // Cycle the light field colormap with TAB key (with debounce). The palette is a GL
+  // texture, so this stays on the GL thread.
+  static bool tabKeyWasPressed = false;
+  bool tabKeyIsPressed = (glfwGetKey(window, GLFW_KEY_TAB) == GLFW_PRESS);
+
+  if (tabKeyIsPressed && !tabKeyWasPressed) {
+    paletteIndex = (paletteIndex + 1) % (BUILTIN_PALETTE_COUNT + static_cast<int>(customPalettes.size()));
+    ApplyPalette();
+  }
+
+  tabKeyWasPressed = tabKeyIsPressed;
+
+  // Cycle worker thread count with W key (with debounce): 1, 2, 4, ... up to one per core
+  static bool wKeyWasPressed = false;
+  bool wKeyIsPressed = (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS);
+
+  if (wKeyIsPressed && !wKeyWasPressed) {
+    Post([this] {
+      int maxThreads = ThreadPool::HardwareThreads();
+      int current = workers.GetThreadCount();
+      int next = current >= maxThreads ? 1 : std::min(current * 2, maxThreads);
+      workers.SetThreadCount(next);
+      if (!useBinnedAccumulation) lightField->SetShardCount(workers.GetThreadCount());
+      std::cout << "Worker threads: " << workers.GetThreadCount() << std::endl;
+    });
+  }
+
+  wKeyWasPressed = wKeyIsPressed;
+
   // Print parameters with P key (with debounce)
   static bool pKeyWasPressed = false;
   bool pKeyIsPressed = (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS);
 
   if (pKeyIsPressed && !pKeyWasPressed) {
-    // Key just pressed - print parameters
-    std::cout << "\n=== Current Parameters ===" << std::endl;
-    std::cout << "Black hole mass: " << blackholeMass << std::endl;
-    std::cout << "Black hole radius: " << blackholeRadius << std::endl;
-    std::cout << "Light speed: " << raySpeed << std::endl;
-    std::cout << "Gravity multiplier: " << LightRay::GetGravityMultiplier() << std::endl;
-    std::cout << "Max force cap: " << LightRay::GetMaxForce() << std::endl;
-    std::cout << "Force exponent: " << LightRay::GetForceExponent() << std::endl;
-    std::cout << "Number of rays: " << NUM_RAYS << std::endl;
-    std::cout << "Grid decay rate: " << lightField->GetDecayRate() << std::endl;
-    std::cout << "Display threshold: " << lightField->GetDisplayThreshold() << std::endl;
-    std::cout << "Zoom level: " << zoomLevel << "x" << std::endl;
-    std::cout << "Respawn time: " << "0.1 seconds" << std::endl;
-    std::cout << "=========================" << std::endl;
+    Post([this] {
+      // Key just pressed - print parameters
+      std::cout << "\n=== Current Parameters ===" << std::endl;
+      std::cout << "Black hole mass: " << blackholeMass << std::endl;
+      std::cout << "Black hole radius: " << blackholeRadius << std::endl;
+      std::cout << "Light speed: " << raySpeed << std::endl;
+      std::cout << "Gravity multiplier: " << LightRay::GetGravityMultiplier() << std::endl;
+      std::cout << "Max force cap: " << LightRay::GetMaxForce() << std::endl;
+      std::cout << "Force exponent: " << LightRay::GetForceExponent() << std::endl;
+      std::cout << "Number of rays: " << NUM_RAYS << std::endl;
+      std::cout << "Random seed: 0x" << std::hex << randomSeed << std::dec << std::endl;
+      std::cout << "Geodesic kernel: " << SimdLevelName(rays.GetSimdLevel()) << std::endl;
+      std::cout << "Integrator: " << IntegratorName(rays.GetIntegrator()) << std::endl;
+      std::cout << "Worker threads: " << workers.GetThreadCount() << " (" << RAY_CHUNK
+        << " rays per task)" << std::endl;
+      std::cout << "Light field accumulation: " << (useBinnedAccumulation ? "binned by tile" : "per-thread shards")
+        << std::endl;
+      std::cout << "Light field decay: " << (lightField->IsLazyDecay() ? "lazy (on write/display)" : "every step")
+        << std::endl;
+      std::cout << "Light field deposit: " << (lightField->IsPathLengthWeighting() ? "path length per cell" : "Bresenham")
+        << std::endl;
+      std::cout << "Light field tiles: " << lightField->GetAllocatedTileCount() << " of "
+        << lightField->GetTileCount() << " allocated (" << (lightField->IsSparse() ? "sparse" : "dense") << ")"
+        << std::endl;
+      const std::vector<uint32_t>& tileChanges = lightField->GetTileChangeFrames();
+      std::cout << "Light field tiles uploaded: " << std::count(tileChanges.begin(), tileChanges.end(),
+        lightField->GetDisplayFrame()) << " of " << lightField->GetTileCount() << " changed in the last frame"
+        << std::endl;
+      std::cout << "Trajectory cache: " << (!useTrajectoryCache ? "disabled"
+        : trajectoryCache.Current() ? "ready" : "rebuilding")
+        << " (" << rays.CountReplaying() << " rays replaying)" << std::endl;
+      std::cout << "Capture prediction: " << (useCapturePrediction ? "enabled" : "disabled")
+        << " (" << rays.CountDoomed() << " rays fast-forwarding)" << std::endl;
+      const WeakFieldSettings& weakField = rays.GetWeakFieldSettings();
+      std::cout << "Weak-field fast path: " << (weakField.enabled ? "enabled" : "disabled")
+        << " (switch radius " << weakField.switchRadius << ", error bound " << weakField.tolerance
+        << ", " << rays.CountCoasting() << " rays in closed form)" << std::endl;
+      std::cout << "Fixed step: " << clock.GetFixedStep() << " s (max " << clock.GetMaxSubsteps()
+        << " per frame, " << clock.GetDroppedTime() << " s dropped)" << std::endl;
+      std::cout << "Grid decay rate: " << lightField->GetDecayRate() << std::endl;
+      std::cout << "Display threshold: " << lightField->GetDisplayThreshold() << std::endl;
+      std::cout << "Zoom level: " << CULL_DISTANCE / cullRadius << "x" << std::endl;
+      std::cout << "Respawn time: " << "0.1 seconds" << std::endl;
+      std::cout << "Respawn budget: " << rays.GetRespawnBudget() << " rays per step ("
+        << rays.CountPendingRespawns() << " waiting)" << std::endl;
+      std::cout << "Last step (busy / wall ms):";
+      for (const TaskGraph::StageTiming& stage : stepGraph.GetStageTimings()) {
+        if (stage.tasks == 0) continue;  // Stage of an earlier graph shape
+        std::cout << " " << stage.name << " " << stage.busyMs << "/" << stage.spanMs;
+      }
+      std::cout << std::endl;
+      std::cout << "=========================" << std::endl;
+    });
   }
 
   pKeyWasPressed = pKeyIsPressed;
 }
 
-void BlackholeApp::Update(float deltaTime) {
-  time += deltaTime;
+void BlackholeApp::Update(float frameTime) {
+  // The simulation thread picks this up with any parameter changes posted before it
+  Post([this, frameTime] { pendingFrameTime += frameTime; });
+}
+
+void BlackholeApp::Post(CommandQueue::Command command) {
+  commands.Push(std::move(command));
+}
+
+bool BlackholeApp::AddPalette(const std::string& path) {
+  CustomPalette palette;
+  if (!LoadPalette(path, palette.colors)) return false;
+  palette.name = path;
+  customPalettes.push_back(std::move(palette));
+  return true;
+}
+
+void BlackholeApp::ApplyPalette() {
+  if (paletteIndex < BUILTIN_PALETTE_COUNT) {
+    PaletteType type = static_cast<PaletteType>(paletteIndex);
+    const PaletteTable& table = BuiltinPalette(type);
+    lightFieldView->SetPalette(table.data(), table.size());
+    std::cout << "Colormap: " << PaletteName(type) << std::endl;
+  }
+  else {
+    const CustomPalette& palette = customPalettes[paletteIndex - BUILTIN_PALETTE_COUNT];
+    lightFieldView->SetPalette(palette.colors.data(), palette.colors.size());
+    std::cout << "Colormap: " << palette.name << " (" << palette.colors.size() << " entries)" << std::endl;
+  }
+}
 
+void BlackholeApp::UpdateCullRadius() {
   // Only update rays that are potentially visible
-  float cullRadius = 3.0f / zoomLevel;  // Adjust based on zoom
-
-  for (auto& ray : rays) {
-    // Skip rays that are far from view
-    const auto& segments = ray->GetSegments();
-    if (!segments.empty()) {
-      float dist = glm::length(segments[0]);
-      if (dist > cullRadius && !ray->IsAbsorbed()) {
-        continue;  // Skip update for distant rays
-      }
+  float radius = CULL_DISTANCE / zoomLevel;  // Adjust based on zoom
+  Post([this, radius] { cullRadius = radius; });
+}
+
+void BlackholeApp::SimulationLoop() {
+  // Run each batch of commands, then simulate the frame time they delivered
+  std::vector<CommandQueue::Command> batch;
+  while (commands.WaitAndDrain(batch)) {
+    for (CommandQueue::Command& command : batch) {
+      command();
+    }
+    if (pendingFrameTime > 0.0f) {
+      Simulate(pendingFrameTime);
+      pendingFrameTime = 0.0f;
     }
+  }
+}
+
+void BlackholeApp::StopSimulation() {
+  commands.Close();
+  if (simThread.joinable()) simThread.join();
+}
+
+void BlackholeApp::Simulate(float frameTime) {
+  // Physics runs in fixed steps; a slow frame runs several (up to the clock's cap)
+  int steps = clock.Advance(frameTime);
+
+  // Keep the trajectory cache in sync with the live parameters; it rebuilds in the background.
+  // Both replay and capture prediction read from it.
+  if (useTrajectoryCache || useCapturePrediction) {
+    TrajectoryKey key;
+    key.blackholeMass = blackholeMass;
+    key.eventHorizon = blackholeRadius;
+    key.gravityMultiplier = LightRay::GetGravityMultiplier();
+    key.maxForce = LightRay::GetMaxForce();
+    key.minDistance = LightRay::GetMinDistance();
+    key.minSpeed = rays.GetMinSpeed();
+    key.maxSpeed = rays.GetMaxSpeed();
+    trajectoryCache.Request(key);
+    rays.SetTrajectoryTable(trajectoryCache.Current());
+  }
+  else {
+    rays.SetTrajectoryTable(nullptr);
+  }
+  rays.SetReplayEnabled(useTrajectoryCache);
+  rays.SetCapturePrediction(useCapturePrediction);
+
+  // The last step also resolves the grid for display, blended between fixed steps, tile by tile
+  GridFrame& frame = gridFrames.Back();
+  frame.displayFrame = lightField->BeginDisplayFrame();
+  for (int step = 0; step < steps; step++) {
+    Step(clock.GetFixedStep(), step == steps - 1 ? &frame.intensity : nullptr);
+  }
+  if (steps == 0) {
+    lightField->Resolve(clock.GetAlpha(), frame.intensity);
+  }
+
+  // Hand the frame to the GL thread
+  frame.tileChanges = lightField->GetTileChangeFrames();
+  frame.tileVisible = lightField->GetTileVisible();
+  frame.displayThreshold = lightField->GetDisplayThreshold();
+  frame.maxBrightness = lightField->GetMaxBrightness();
+  frame.blackholeRadius = blackholeRadius;
+  gridFrames.Publish();
+}
 
-    ray->Update(deltaTime, blackholePos, blackholeMass, blackholeRadius);
+void BlackholeApp::Step(float deltaTime, std::vector<float>* displayTarget) {
+  time += deltaTime;
+
+  lightField->BeginStep();
+  if (useBinnedAccumulation) {
+    lightField->BeginBinning((rays.Size() + RAY_CHUNK - 1) / RAY_CHUNK);
   }
+  rays.BeginUpdate();
+
+  // The graph only changes shape with the accumulation mode or the ray or tile count;
+  // everything else a step needs, its tasks read from here
+  StepGraphShape shape = { useBinnedAccumulation, rays.Size(), lightField->GetTileCount() };
+  if (shape != stepGraphShape) BuildStepGraph(shape);
+  stepDeltaTime = deltaTime;
+  stepAlpha = clock.GetAlpha();
+  stepDisplay = displayTarget;
 
-  UpdateLightField();
-  lightField->Update(deltaTime);
+  stepGraph.Run(workers);
+}
+
+void BlackholeApp::BuildStepGraph(const StepGraphShape& shape) {
+  // Ray chunks -> chunks done -> (respawn | sort bins -> tile ranges | tile ranges)
+  stepGraph.Clear();
+  stepGraphShape = shape;
+
+  // One sweep over the rays: each chunk is integrated, checked for reset and has its
+  // head segments accumulated while its state is still in cache
+  std::vector<TaskGraph::TaskId> chunks;
+  for (size_t begin = 0; begin < shape.rayCount; begin += RAY_CHUNK) {
+    size_t end = std::min(shape.rayCount, begin + RAY_CHUNK);
+    chunks.push_back(stepGraph.AddTask("integrate", [this, begin, end](size_t slot) {
+      rays.Update(begin, end, stepDeltaTime, blackholePos, blackholeMass, blackholeRadius, cullRadius);
+      AccumulateRays(slot, begin, end);
+    }));
+  }
+
+  // Everything after the sweep waits on this one task, not on every chunk
+  TaskGraph::TaskId chunksDone = stepGraph.AddTask("chunks done", [](size_t) {});
+  for (TaskGraph::TaskId chunk : chunks) stepGraph.AddDependency(chunk, chunksDone);
+
+  // Respawns only touch ray state, so they overlap the grid work
+  TaskGraph::TaskId respawn = stepGraph.AddTask("respawn", [this](size_t) {
+    rays.EndUpdate();
+    rays.ProcessRespawns();
+  });
+  stepGraph.AddDependency(chunksDone, respawn);
+
+  // Binned segments are grouped by tile once every chunk has filed its own
+  TaskGraph::TaskId tilesReady = chunksDone;
+  if (shape.binned) {
+    tilesReady = stepGraph.AddTask("sort bins", [this](size_t) { lightField->SortBins(); });
+    stepGraph.AddDependency(chunksDone, tilesReady);
+  }
+
+  // Each range of tiles is drawn (or has its shards merged), then decayed while still in
+  // cache. The displayed step decays and resolves each cell in the same sweep; with lazy
+  // decay, steps that are not displayed have no per-tile work left after drawing.
+  for (size_t begin = 0; begin < shape.tileCount; begin += TILE_CHUNK) {
+    size_t end = std::min(shape.tileCount, begin + TILE_CHUNK);
+    bool binned = shape.binned;
+    TaskGraph::TaskId tiles = stepGraph.AddTask("accumulate+decay", [this, begin, end, binned](size_t) {
+      if (binned) {
+        lightField->RasterizeTiles(begin, end);
+      }
+      else {
+        lightField->MergeShards(begin, end);
+      }
+      if (stepDisplay) {
+        lightField->DecayAndResolve(stepAlpha, *stepDisplay, begin, end);
+      }
+      else {
+        lightField->Decay(begin, end);
+      }
+    });
+    stepGraph.AddDependency(tilesReady, tiles);
+  }
 }
 
 void BlackholeApp::Render() {
   glClearColor(0.05f, 0.05f, 0.1f, 1.0f);  // Dark blue background
   glClear(GL_COLOR_BUFFER_BIT);
 
+  // Upload the newest grid the simulation thread has finished, if there is one
+  if (gridFrames.Acquire()) {
+    const GridFrame& frame = gridFrames.Front();
+    lightFieldView->Upload(frame.intensity, frame.tileChanges, frame.tileVisible, frame.displayFrame,
+      frame.displayThreshold, frame.maxBrightness);
+    drawnBlackholeRadius = frame.blackholeRadius;
+  }
+
   // Render the light field grid (density visualization)
-  lightField->Render(gridShaderProgram);
+  lightFieldView->Render(gridShaderProgram);
 
   // Draw black hole on top
   DrawBlackhole();
@@ -8,8 +8,18 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <thread>
 #include "LightRay.h"
+#include "RayBatch.h"
+#include "TrajectoryCache.h"
 #include "LightFieldGrid.h"
+#include "LightFieldView.h"
+#include "SimulationClock.h"
+#include "ThreadPool.h"
+#include "TaskGraph.h"
+#include "CommandQueue.h"
+#include "TripleBuffer.h"
+#include "StreamBuffer.h"
 
 class BlackholeApp {
 public:
@@ -22,12 +32,16 @@ public:
   // Main render loop
   void Render();
 
-  // Update physics/animation
-  void Update(float deltaTime);
+  // Hand one render frame's wall-clock time to the simulation thread (does not wait for it)
+  void Update(float frameTime);
 
-  // Handle input
+  // Handle input; parameter changes are posted to the simulation thread
   void ProcessInput(GLFWwindow* window);
 
+  // Add a colormap read from a text file (see LoadPalette) after the built-in ones cycled
+  // with TAB; returns false if the file is not a valid palette
+  bool AddPalette(const std::string& path);
+
   // Check if app should close
   bool ShouldClose() const;
 
@@ -46,24 +60,86 @@ private:
   GLFWwindow* window;
   unsigned int shaderProgram;
   unsigned int gridShaderProgram;  // New shader for grid rendering
-  unsigned int lineVAO, lineVBO;
+  unsigned int lineVAO;
+  std::unique_ptr<StreamBuffer> overlayStream;  // Per-frame overlay vertices, written in place
+  std::unique_ptr<LightFieldView> lightFieldView;  // Texture the grid frames are drawn from
 
   // Black hole parameters - ALWAYS CENTERED
   glm::vec2 blackholePos;      // Always (0, 0) in normalized coords
   float blackholeRadius;        // Visual radius of black hole (event horizon)
   float blackholeMass;          // Mass (affects gravity strength)
+  float drawnBlackholeRadius;   // Radius in the frame being shown (GL thread copy)
 
   // Light rays
   static const int NUM_RAYS = 8000;  // 2000 rays for dense field
-  std::vector<std::unique_ptr<LightRay>> rays;
+  static const int TRAIL_CAPACITY = 64;  // Trail points kept per ray (reset checks read the newest 20)
+  RayBatch rays;
+  uint64_t randomSeed;          // Seeds spawn and reset jitter (same seed, same run)
+
+  // Ray updates are split into fixed chunks shared out across the pool
+  // Rays per task: a multiple of every SIMD width, and small enough (~200 KB of ray
+  // state and trails) that a chunk stays in L2 between integration and accumulation
+  static const int RAY_CHUNK = 256;
+  // Light field tiles per task (~100 KB of cell state, so a range stays in L2 between
+  // accumulation and decay)
+  static const int TILE_CHUNK = 8;
+  ThreadPool workers;
+
+  // Stages of one fixed step, built once and run every step until its shape changes
+  struct StepGraphShape {
+    bool binned = false;        // Binned accumulation rather than shards
+    size_t rayCount = 0;        // 0: not built yet
+    size_t tileCount = 0;
+    bool operator==(const StepGraphShape&) const = default;
+  };
+  TaskGraph stepGraph;
+  StepGraphShape stepGraphShape;
+  float stepDeltaTime;          // Inputs of the step being run, read by its tasks
+  float stepAlpha;
+  std::vector<float>* stepDisplay;  // Resolve target, or null when the step is not displayed
+
+  // Precomputed photon paths replayed instead of integrated
+  TrajectoryCache trajectoryCache;
+  bool useTrajectoryCache;
+  bool useCapturePrediction;    // Fast-forward rays the table says are captured
 
   // Light field grid for density visualization
+  static constexpr int LIGHT_FIELD_RESOLUTION = 256;  // Cells per side
+  static constexpr bool LIGHT_FIELD_SPARSE = false;   // Allocate grid tiles on demand (for very large grids)
   std::unique_ptr<LightFieldGrid> lightField;
+  bool useBinnedAccumulation;   // Bin segments by tile instead of drawing into per-thread shards
+
+  // Colormaps (GL thread): the built-in tables, then custom ones in the order added
+  struct CustomPalette {
+    std::string name;
+    std::vector<PaletteColor> colors;
+  };
+  std::vector<CustomPalette> customPalettes;
+  int paletteIndex;
 
   // Animation
+  SimulationClock clock;        // Fixed-step physics clock fed by the render loop
   float time;
   float raySpeed;               // Speed of light (adjustable)
   float zoomLevel;              // Zoom level for camera
+  static constexpr float CULL_DISTANCE = 3.0f;  // Rays further out (at 1x zoom) are not updated
+  float cullRadius;             // CULL_DISTANCE / zoom (simulation thread copy)
+
+  // Simulation thread: runs commands and fixed steps while the GL thread presents.
+  // Everything above except the window, GL handles and zoomLevel belongs to it once started.
+  struct GridFrame {
+    std::vector<float> intensity; // Resolved light field cells, one float each
+    std::vector<uint32_t> tileChanges;  // Display frame each tile last changed in
+    std::vector<uint8_t> tileVisible;   // Tiles drawing more than black (others: zero)
+    uint32_t displayFrame;        // Display frame the cells were resolved in
+    float displayThreshold;       // Colour mapping they are drawn with
+    float maxBrightness;
+    float blackholeRadius;
+  };
+  std::thread simThread;
+  CommandQueue commands;        // Parameter changes and frame time from the GL thread
+  TripleBuffer<GridFrame> gridFrames;  // Finished frames, newest wins
+  float pendingFrameTime;       // Frame time delivered but not yet simulated
 
   // Shader sources
   static const char* vertexShaderSource;
@@ -80,7 +156,16 @@ private:
   void UpdateRaySpeed(float newSpeed);
   void DrawBlackhole();
   void DrawRays();
-  void UpdateLightField();
+  void AccumulateRays(size_t slot, size_t begin, size_t end);  // Head segments of rays [begin, end)
+  bool GetHeadSegment(size_t index, glm::vec2& start, glm::vec2& end) const;  // Latest movement of a ray
+  void Step(float deltaTime, std::vector<float>* displayTarget);  // One fixed step; resolves the grid if given a target
+  void BuildStepGraph(const StepGraphShape& shape);
+  void Simulate(float frameTime);  // Fixed steps for one frame, then publish the grid
+  void SimulationLoop();
+  void StopSimulation();
+  void Post(CommandQueue::Command command);  // Run on the simulation thread before its next frame
+  void UpdateCullRadius();
+  void ApplyPalette();  // Upload palette paletteIndex to the light field view
   unsigned int CompileShader(unsigned int type, const char* source);
   unsigned int CreateShaderProgram(const char* vertSource, const char* fragSource);
 };
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "ColorPalette.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+const PaletteTable& BuiltinPalette(PaletteType type) {
+  switch (type) {
+  case PaletteType::Ember: return EMBER_PALETTE;
+  case PaletteType::Gray: return GRAY_PALETTE;
+  default: return HEAT_PALETTE;
+  }
+}
+
+const char* PaletteName(PaletteType type) {
+  switch (type) {
+  case PaletteType::Heat: return "Heat";
+  case PaletteType::Ember: return "Ember";
+  case PaletteType::Gray: return "Gray";
+  }
+  return "Unknown";
+}
+
+bool LoadPalette(const std::string& path, std::vector<PaletteColor>& colors) {
+  std::ifstream file(path);
+  if (!file) return false;
+
+  std::vector<PaletteColor> entries;
+  std::string line;
+  while (std::getline(file, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') continue;
+
+    std::istringstream fields(line);
+    PaletteColor color;
+    if (!(fields >> color.r >> color.g >> color.b)) return false;
+    color.r = std::clamp(color.r, 0.0f, 1.0f);
+    color.g = std::clamp(color.g, 0.0f, 1.0f);
+    color.b = std::clamp(color.b, 0.0f, 1.0f);
+    entries.push_back(color);
+    if (entries.size() > MAX_PALETTE_SIZE) return false;
+  }
+
+  if (entries.size() < 2) return false;
+  colors = std::move(entries);
+  return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Colormaps as lookup tables.
+// The light field shader maps a cell's intensity to [0, 1] between the display threshold
+// and the max brightness and fetches the palette entry there (one texture read, no
+// per-segment branches), so a colormap is data: the built-in ones are tabulated at
+// compile time and custom ones are loaded from text files.
+
+struct PaletteColor {
+  float r, g, b;
+};
+
+// Entries in a built-in table: fine enough that linear filtering between entries
+// reproduces the ramps to within a fraction of an 8-bit step
+static const size_t PALETTE_SIZE = 256;
+using PaletteTable = std::array<PaletteColor, PALETTE_SIZE>;
+
+// Largest custom palette accepted (also well within every GL implementation's texture size)
+static const size_t MAX_PALETTE_SIZE = 4096;
+
+// Piecewise-linear ramp through evenly spaced stops (first stop at 0, last at 1)
+template <size_t STOPS>
+constexpr PaletteTable MakePalette(const PaletteColor (&stops)[STOPS]) {
+  static_assert(STOPS >= 2, "a ramp needs two stops");
+  PaletteTable table{};
+  for (size_t i = 0; i < PALETTE_SIZE; i++) {
+    float position = static_cast<float>(i) * (STOPS - 1) / (PALETTE_SIZE - 1);
+    size_t segment = static_cast<size_t>(position);
+    if (segment > STOPS - 2) segment = STOPS - 2;
+    float f = position - static_cast<float>(segment);
+    const PaletteColor& a = stops[segment];
+    const PaletteColor& b = stops[segment + 1];
+    table[i] = { a.r + (b.r - a.r) * f, a.g + (b.g - a.g) * f, a.b + (b.b - a.b) * f };
+  }
+  return table;
+}
+
+// Built-in colormaps, cycled in this order
+enum class PaletteType {
+  Heat,    // Black -> dark blue -> blue -> cyan -> white (the original ramp)
+  Ember,   // Black -> red -> orange -> yellow -> white
+  Gray     // Black -> white
+};
+
+static const int BUILTIN_PALETTE_COUNT = 3;
+
+inline constexpr PaletteColor HEAT_STOPS[] = {
+  { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.3f }, { 0.0f, 0.2f, 0.7f }, { 0.3f, 0.7f, 1.0f }, { 1.0f, 1.0f, 1.0f }
+};
+inline constexpr PaletteColor EMBER_STOPS[] = {
+  { 0.0f, 0.0f, 0.0f }, { 0.5f, 0.0f, 0.0f }, { 0.9f, 0.35f, 0.0f }, { 1.0f, 0.8f, 0.2f }, { 1.0f, 1.0f, 1.0f }
+};
+inline constexpr PaletteColor GRAY_STOPS[] = {
+  { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f }
+};
+
+inline constexpr PaletteTable HEAT_PALETTE = MakePalette(HEAT_STOPS);
+inline constexpr PaletteTable EMBER_PALETTE = MakePalette(EMBER_STOPS);
+inline constexpr PaletteTable GRAY_PALETTE = MakePalette(GRAY_STOPS);
+
+const PaletteTable& BuiltinPalette(PaletteType type);
+
+// Human-readable name of a built-in colormap
+const char* PaletteName(PaletteType type);
+
+// Read a custom palette: one "r g b" entry per line, components in [0, 1], entries evenly
+// spaced from the display threshold to the max brightness. Blank lines and lines starting
+// with '#' are skipped. Returns false (leaving colors untouched) if the file cannot be read
+// or holds fewer than 2 or more than MAX_PALETTE_SIZE entries.
+bool LoadPalette(const std::string& path, std::vector<PaletteColor>& colors);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Multi-producer queue of closures run by one consumer thread.
+// Producers never block on the consumer's work: Push only appends under a short lock,
+// and the consumer swaps the whole batch out before running it.
+class CommandQueue {
+public:
+  using Command = std::function<void()>;
+
+  void Push(Command command) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending.push_back(std::move(command));
+    }
+    ready.notify_one();
+  }
+
+  // Block until commands arrive (or the queue is closed), then move them all into batch.
+  // Returns false once the queue is closed and empty.
+  bool WaitAndDrain(std::vector<Command>& batch) {
+    batch.clear();
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [this] { return closed || !pending.empty(); });
+    batch.swap(pending);
+    return !batch.empty() || !closed;
+  }
+
+  // Wake the consumer for the last time
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+    }
+    ready.notify_all();
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::vector<Command> pending;
+  bool closed = false;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+// Counter-based random numbers: Philox4x32-10 (Salmon et al., "Parallel Random
+// Numbers: As Easy as 1, 2, 3", SC 2011).
+// Each block of four 32-bit words is a pure function of (seed, counter), so every ray
+// draws its own numbers from its index and reset generation. There is no shared
+// generator state: draws are thread-safe, order-independent and reproducible per seed.
+
+// Independent sequences for the same ray, selected by the third counter word
+enum RandomStream : uint32_t {
+  RANDOM_STREAM_SPAWN = 0,  // Launch parameters chosen when the ray set is built
+  RANDOM_STREAM_RESET = 1   // Jitter applied every time a ray restarts
+};
+
+struct RandomBlock {
+  uint32_t word[4];
+
+  // Word n mapped to [lo, hi) using its top 24 bits (exact in float)
+  float Uniform(int n, float lo, float hi) const {
+    return lo + (hi - lo) * static_cast<float>(word[n] >> 8) * (1.0f / 16777216.0f);
+  }
+};
+
+// Round constants, shared with the vectorized generator in RayResetKernelSimd.h
+constexpr uint32_t PHILOX_M0 = 0xD2511F53u, PHILOX_M1 = 0xCD9E8D57u;  // Round multipliers
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9u, PHILOX_W1 = 0xBB67AE85u;  // Key schedule (Weyl sequence)
+constexpr int PHILOX_ROUNDS = 10;
+
+inline RandomBlock Philox4x32(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint64_t seed) {
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+
+  for (int round = 0; round < PHILOX_ROUNDS; round++) {
+    uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+    uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+    uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+    uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = lo0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  return { { c0, c1, c2, c3 } };
+}
@@ -0,0 +1,167 @@
+#include "GeodesicKernel.h"
+#include "GeodesicKernelSimd.h"
+#include "LightRay.h"
+#include <glm/glm.hpp>
+
+#if defined(OPENGLFW_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+void GeodesicStepScalar(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params) {
+  glm::vec2 blackholePos(params.blackholeX, params.blackholeY);
+
+  for (size_t i = begin; i < end; ++i) {
+    if (!rays.mask[i]) continue;
+
+    // Absorbed rays only advance their absorption timer
+    if (rays.absorbed[i]) {
+      rays.absorbTimer[i] += params.deltaTime;
+      continue;
+    }
+
+    glm::vec2 position(rays.posX[i], rays.posY[i]);
+    glm::vec2 velocity(rays.velX[i], rays.velY[i]);
+    float r = glm::length(position - blackholePos);
+
+    // Effective time step (proper time)
+    float effectiveDeltaTime = params.deltaTime / LightRay::CalculateTimeDilation(r, params.blackholeMass);
+    rays.properTime[i] += effectiveDeltaTime;
+
+    glm::vec2 acceleration = LightRay::CalculateGeodesicDeflection(position, velocity,
+      blackholePos, params.blackholeMass, rays.angularMomentum[i],
+      params.gravityMultiplier, params.maxForce, params.minDistance);
+
+    // Only direction changes; light always travels at its base speed
+    glm::vec2 newVelocity = velocity + acceleration * effectiveDeltaTime;
+    if (glm::length(newVelocity) > 0.001f) {
+      velocity = glm::normalize(newVelocity) * rays.speed[i];
+    }
+    position += velocity * effectiveDeltaTime;
+
+    // Recalculate angular momentum for numerical stability
+    rays.angularMomentum[i] = position.x * velocity.y - position.y * velocity.x;
+
+    // Freeze at the event horizon once crossed
+    if (r < params.eventHorizon) {
+      rays.absorbed[i] = 1;
+      rays.absorbTimer[i] = 0.0f;
+      position = blackholePos - glm::normalize(blackholePos - position) * params.eventHorizon;
+    }
+
+    rays.posX[i] = position.x;
+    rays.posY[i] = position.y;
+    rays.velX[i] = velocity.x;
+    rays.velY[i] = velocity.y;
+  }
+}
+
+#if defined(OPENGLFW_SIMD_X86)
+static void CpuId(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+  int r[4];
+  __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; i++) regs[i] = static_cast<unsigned>(r[i]);
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Register state the OS saves on context switch (XCR0)
+static unsigned long long XGetBV() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned lo, hi;
+  __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+}
+
+static SimdLevel DetectX86() {
+  unsigned regs[4];
+  CpuId(0, 0, regs);
+  unsigned maxLeaf = regs[0];
+  if (maxLeaf < 1) return SimdLevel::Scalar;
+
+  CpuId(1, 0, regs);
+  bool sse41 = (regs[2] >> 19) & 1;
+  bool osxsave = (regs[2] >> 27) & 1;
+  bool avx = (regs[2] >> 28) & 1;
+
+  unsigned long long xcr0 = osxsave ? XGetBV() : 0;
+  bool osAvx = (xcr0 & 0x6) == 0x6;        // XMM + YMM state
+  bool osAvx512 = (xcr0 & 0xE6) == 0xE6;   // + opmask and ZMM state
+
+  bool avx2 = false;
+  bool avx512 = false;
+  if (maxLeaf >= 7) {
+    CpuId(7, 0, regs);
+    avx2 = (regs[1] >> 5) & 1;
+    avx512 = (regs[1] >> 16) & 1;
+  }
+
+  if (avx512 && osAvx512) return SimdLevel::AVX512;
+  if (avx2 && avx && osAvx) return SimdLevel::AVX2;
+  if (sse41) return SimdLevel::SSE41;
+  return SimdLevel::Scalar;
+}
+#endif
+
+SimdLevel DetectSimdLevel() {
+#if defined(OPENGLFW_SIMD_X86)
+  static const SimdLevel level = DetectX86();
+  return level;
+#elif defined(OPENGLFW_SIMD_NEON)
+  return SimdLevel::NEON;  // Always present on AArch64
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel ClampSimdLevel(SimdLevel requested) {
+  SimdLevel best = DetectSimdLevel();
+  if (requested == SimdLevel::Scalar) return SimdLevel::Scalar;
+  if (best == SimdLevel::NEON || requested == SimdLevel::NEON) {
+    return requested == best ? best : SimdLevel::Scalar;
+  }
+  return static_cast<int>(requested) <= static_cast<int>(best) ? requested : best;
+}
+
+GeodesicStepFn GetGeodesicStepKernel(SimdLevel level) {
+  switch (ClampSimdLevel(level)) {
+#if defined(OPENGLFW_SIMD_X86)
+  case SimdLevel::SSE41: return GeodesicStepSSE41;
+  case SimdLevel::AVX2: return GeodesicStepAVX2;
+  case SimdLevel::AVX512: return GeodesicStepAVX512;
+#endif
+#if defined(OPENGLFW_SIMD_NEON)
+  case SimdLevel::NEON: return GeodesicStepNEON;
+#endif
+  default: return GeodesicStepScalar;
+  }
+}
+
+int SimdLevelWidth(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::SSE41: return 4;
+  case SimdLevel::AVX2: return 8;
+  case SimdLevel::AVX512: return 16;
+  case SimdLevel::NEON: return 4;
+  default: return 1;
+  }
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::SSE41: return "SSE4.1";
+  case SimdLevel::AVX2: return "AVX2";
+  case SimdLevel::AVX512: return "AVX-512";
+  case SimdLevel::NEON: return "NEON";
+  default: return "Scalar";
+  }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Instruction set used by the geodesic step kernel
+enum class SimdLevel {
+  Scalar,
+  SSE41,   // 4 rays per instruction
+  AVX2,    // 8 rays per instruction
+  AVX512,  // 16 rays per instruction
+  NEON     // 4 rays per instruction
+};
+
+// Uniform parameters for one propagation step
+struct GeodesicStepParams {
+  float deltaTime;
+  float blackholeX, blackholeY;
+  float blackholeMass;
+  float eventHorizon;
+  float gravityMultiplier;
+  float maxForce;
+  float minDistance;
+};
+
+// Structure-of-arrays view of the ray state advanced by the kernel
+struct GeodesicStepArrays {
+  float* posX;
+  float* posY;
+  float* velX;
+  float* velY;
+  const float* speed;
+  float* angularMomentum;
+  float* properTime;
+  float* absorbTimer;
+  uint8_t* absorbed;
+  const uint8_t* mask;  // Rays with a zero mask byte are left untouched
+};
+
+// Advances rays [begin, end) by one step
+using GeodesicStepFn = void (*)(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params);
+
+// Scalar reference implementation, built on the LightRay physics helpers
+void GeodesicStepScalar(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params);
+
+// Widest instruction set supported by this CPU (queried once via CPUID)
+SimdLevel DetectSimdLevel();
+
+// Clamp a requested level to what this CPU and build support
+SimdLevel ClampSimdLevel(SimdLevel requested);
+
+// Kernel for a level; unsupported levels fall back to the scalar kernel
+GeodesicStepFn GetGeodesicStepKernel(SimdLevel level);
+
+// Number of rays advanced per instruction
+int SimdLevelWidth(SimdLevel level);
+
+// Human-readable name of a level
+const char* SimdLevelName(SimdLevel level);
@@ -0,0 +1,83 @@
+// AVX2 geodesic step, light field resolve and ray reset kernels: 8 lanes per instruction.
+// Built with AVX2 enabled; only called after CPUID confirms support.
+#include "GeodesicKernelSimd.h"
+#include "LightFieldKernelSimd.h"
+#include "RayResetKernelSimd.h"
+
+#if defined(OPENGLFW_SIMD_X86)
+#include <immintrin.h>
+
+namespace {
+
+struct AVX2 {
+  static constexpr size_t Width = 8;
+  struct F { __m256 v; };
+  struct M { __m256 v; };
+  struct U { __m256i v; };
+
+  static F Set(float x) { return { _mm256_set1_ps(x) }; }
+  static F Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+  static void Store(float* p, F x) { _mm256_storeu_ps(p, x.v); }
+  static M LoadMask(const uint8_t* p) {
+    __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+    return { _mm256_castsi256_ps(_mm256_cmpgt_epi32(lanes, _mm256_setzero_si256())) };
+  }
+  static unsigned Bits(M m) { return static_cast<unsigned>(_mm256_movemask_ps(m.v)); }
+  static F Sqrt(F x) { return { _mm256_sqrt_ps(x.v) }; }
+  static F Min(F a, F b) { return { _mm256_min_ps(a.v, b.v) }; }
+  static F Max(F a, F b) { return { _mm256_max_ps(a.v, b.v) }; }
+  static F Abs(F x) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x.v) }; }
+  static F Select(M m, F a, F b) { return { _mm256_blendv_ps(b.v, a.v, m.v) }; }
+  static M AndNot(M a, M b) { return { _mm256_andnot_ps(a.v, b.v) }; }
+
+  static U SetU(uint32_t x) { return { _mm256_set1_epi32(static_cast<int>(x)) }; }
+  static U LoadU(const uint32_t* p) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) }; }
+  static void StoreU(uint32_t* p, U x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x.v); }
+  static void MulWide(U a, U b, U& hi, U& lo) {
+    // Even lanes, then odd lanes moved down; each product fills a 64-bit half
+    __m256i even = _mm256_mul_epu32(a.v, b.v);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a.v, 32), _mm256_srli_epi64(b.v, 32));
+    lo = { _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA) };
+    hi = { _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA) };
+  }
+  static M Nonzero(U x) {
+    __m256i zero = _mm256_cmpeq_epi32(x.v, _mm256_setzero_si256());
+    return { _mm256_castsi256_ps(_mm256_xor_si256(zero, _mm256_set1_epi32(-1))) };
+  }
+  static U RoundToInt(F x) { return { _mm256_cvtps_epi32(x.v) }; }
+  static F ToFloat(U x) { return { _mm256_cvtepi32_ps(x.v) }; }
+  static F ToUnit(U x) {
+    __m256 top = _mm256_cvtepi32_ps(_mm256_srli_epi32(x.v, 8));
+    return { _mm256_mul_ps(top, _mm256_set1_ps(1.0f / 16777216.0f)) };
+  }
+};
+
+inline AVX2::F operator+(AVX2::F a, AVX2::F b) { return { _mm256_add_ps(a.v, b.v) }; }
+inline AVX2::F operator-(AVX2::F a, AVX2::F b) { return { _mm256_sub_ps(a.v, b.v) }; }
+inline AVX2::F operator*(AVX2::F a, AVX2::F b) { return { _mm256_mul_ps(a.v, b.v) }; }
+inline AVX2::F operator/(AVX2::F a, AVX2::F b) { return { _mm256_div_ps(a.v, b.v) }; }
+inline AVX2::M operator<(AVX2::F a, AVX2::F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline AVX2::M operator<=(AVX2::F a, AVX2::F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+inline AVX2::M operator>(AVX2::F a, AVX2::F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+inline AVX2::M operator&(AVX2::M a, AVX2::M b) { return { _mm256_and_ps(a.v, b.v) }; }
+inline AVX2::M operator|(AVX2::M a, AVX2::M b) { return { _mm256_or_ps(a.v, b.v) }; }
+inline AVX2::U operator+(AVX2::U a, AVX2::U b) { return { _mm256_add_epi32(a.v, b.v) }; }
+inline AVX2::U operator^(AVX2::U a, AVX2::U b) { return { _mm256_xor_si256(a.v, b.v) }; }
+inline AVX2::U operator&(AVX2::U a, AVX2::U b) { return { _mm256_and_si256(a.v, b.v) }; }
+
+}  // namespace
+
+void GeodesicStepAVX2(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params) {
+  GeodesicStepSimd<AVX2>(rays, begin, end, params);
+}
+
+bool LightFieldResolveAVX2(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params) {
+  return LightFieldResolveSimd<AVX2>(row, count, params);
+}
+
+void RayResetAVX2(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params) {
+  RayResetSimd<AVX2>(lanes, begin, end, params);
+}
+#endif
@@ -0,0 +1,88 @@
+// AVX-512 geodesic step, light field resolve and ray reset kernels: 16 lanes per instruction.
+// Built with AVX-512F enabled; only called after CPUID confirms support.
+#include "GeodesicKernelSimd.h"
+#include "LightFieldKernelSimd.h"
+#include "RayResetKernelSimd.h"
+
+#if defined(OPENGLFW_SIMD_X86)
+#include <immintrin.h>
+
+namespace {
+
+struct AVX512 {
+  static constexpr size_t Width = 16;
+  struct F { __m512 v; };
+  struct M { __mmask16 v; };
+  struct U { __m512i v; };
+
+  // GCC's unmasked forms of some intrinsics pass an undefined source through the masked
+  // builtin, which -Wall reports as maybe-uninitialized; the zero-masking forms with every
+  // lane enabled compile to the same instructions without it
+  static constexpr __mmask16 ALL = 0xFFFF;
+  static constexpr __mmask8 ALL_PAIRS = 0xFF;  // Every 64-bit lane
+
+  static F Set(float x) { return { _mm512_set1_ps(x) }; }
+  static F Load(const float* p) { return { _mm512_loadu_ps(p) }; }
+  static void Store(float* p, F x) { _mm512_storeu_ps(p, x.v); }
+  static M LoadMask(const uint8_t* p) {
+    __m512i lanes = _mm512_maskz_cvtepu8_epi32(ALL, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    return { _mm512_test_epi32_mask(lanes, lanes) };
+  }
+  static unsigned Bits(M m) { return static_cast<unsigned>(m.v); }
+  static F Sqrt(F x) { return { _mm512_maskz_sqrt_ps(ALL, x.v) }; }
+  static F Min(F a, F b) { return { _mm512_maskz_min_ps(ALL, a.v, b.v) }; }
+  static F Max(F a, F b) { return { _mm512_maskz_max_ps(ALL, a.v, b.v) }; }
+  static F Abs(F x) { return { _mm512_abs_ps(x.v) }; }
+  static F Select(M m, F a, F b) { return { _mm512_mask_blend_ps(m.v, b.v, a.v) }; }
+  static M AndNot(M a, M b) { return { static_cast<__mmask16>(~a.v & b.v) }; }
+
+  static U SetU(uint32_t x) { return { _mm512_set1_epi32(static_cast<int>(x)) }; }
+  static U LoadU(const uint32_t* p) { return { _mm512_loadu_si512(p) }; }
+  static void StoreU(uint32_t* p, U x) { _mm512_storeu_si512(p, x.v); }
+  static void MulWide(U a, U b, U& hi, U& lo) {
+    // Even lanes, then odd lanes moved down; each product fills a 64-bit half
+    __m512i oddA = _mm512_maskz_srli_epi64(ALL_PAIRS, a.v, 32);
+    __m512i oddB = _mm512_maskz_srli_epi64(ALL_PAIRS, b.v, 32);
+    __m512i even = _mm512_maskz_mul_epu32(ALL_PAIRS, a.v, b.v);
+    __m512i odd = _mm512_maskz_mul_epu32(ALL_PAIRS, oddA, oddB);
+    lo = { _mm512_mask_blend_epi32(0xAAAA, even, _mm512_maskz_slli_epi64(ALL_PAIRS, odd, 32)) };
+    hi = { _mm512_mask_blend_epi32(0xAAAA, _mm512_maskz_srli_epi64(ALL_PAIRS, even, 32), odd) };
+  }
+  static M Nonzero(U x) { return { _mm512_test_epi32_mask(x.v, x.v) }; }
+  static U RoundToInt(F x) { return { _mm512_maskz_cvtps_epi32(ALL, x.v) }; }
+  static F ToFloat(U x) { return { _mm512_maskz_cvtepi32_ps(ALL, x.v) }; }
+  static F ToUnit(U x) {
+    __m512 top = _mm512_maskz_cvtepi32_ps(ALL, _mm512_maskz_srli_epi32(ALL, x.v, 8));
+    return { _mm512_mul_ps(top, _mm512_set1_ps(1.0f / 16777216.0f)) };
+  }
+};
+
+inline AVX512::F operator+(AVX512::F a, AVX512::F b) { return { _mm512_add_ps(a.v, b.v) }; }
+inline AVX512::F operator-(AVX512::F a, AVX512::F b) { return { _mm512_sub_ps(a.v, b.v) }; }
+inline AVX512::F operator*(AVX512::F a, AVX512::F b) { return { _mm512_mul_ps(a.v, b.v) }; }
+inline AVX512::F operator/(AVX512::F a, AVX512::F b) { return { _mm512_div_ps(a.v, b.v) }; }
+inline AVX512::M operator<(AVX512::F a, AVX512::F b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+inline AVX512::M operator<=(AVX512::F a, AVX512::F b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ) }; }
+inline AVX512::M operator>(AVX512::F a, AVX512::F b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; }
+inline AVX512::M operator&(AVX512::M a, AVX512::M b) { return { static_cast<__mmask16>(a.v & b.v) }; }
+inline AVX512::M operator|(AVX512::M a, AVX512::M b) { return { static_cast<__mmask16>(a.v | b.v) }; }
+inline AVX512::U operator+(AVX512::U a, AVX512::U b) { return { _mm512_add_epi32(a.v, b.v) }; }
+inline AVX512::U operator^(AVX512::U a, AVX512::U b) { return { _mm512_xor_si512(a.v, b.v) }; }
+inline AVX512::U operator&(AVX512::U a, AVX512::U b) { return { _mm512_and_si512(a.v, b.v) }; }
+
+}  // namespace
+
+void GeodesicStepAVX512(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params) {
+  GeodesicStepSimd<AVX512>(rays, begin, end, params);
+}
+
+bool LightFieldResolveAVX512(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params) {
+  return LightFieldResolveSimd<AVX512>(row, count, params);
+}
+
+void RayResetAVX512(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params) {
+  RayResetSimd<AVX512>(lanes, begin, end, params);
+}
+#endif
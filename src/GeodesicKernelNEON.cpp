@@ -0,0 +1,83 @@
+// NEON geodesic step, light field resolve and ray reset kernels: 4 lanes per instruction (AArch64).
+#include "GeodesicKernelSimd.h"
+#include "LightFieldKernelSimd.h"
+#include "RayResetKernelSimd.h"
+
+#if defined(OPENGLFW_SIMD_NEON)
+#include <arm_neon.h>
+#include <cstring>
+
+namespace {
+
+struct NEON {
+  static constexpr size_t Width = 4;
+  struct F { float32x4_t v; };
+  struct M { uint32x4_t v; };
+  struct U { uint32x4_t v; };
+
+  static F Set(float x) { return { vdupq_n_f32(x) }; }
+  static F Load(const float* p) { return { vld1q_f32(p) }; }
+  static void Store(float* p, F x) { vst1q_f32(p, x.v); }
+  static M LoadMask(const uint8_t* p) {
+    uint32_t bytes;
+    std::memcpy(&bytes, p, sizeof(bytes));
+    uint8x8_t narrow = vreinterpret_u8_u32(vdup_n_u32(bytes));
+    uint32x4_t lanes = vmovl_u16(vget_low_u16(vmovl_u8(narrow)));
+    return { vcgtq_u32(lanes, vdupq_n_u32(0)) };
+  }
+  static unsigned Bits(M m) {
+    const uint32x4_t weights = { 1, 2, 4, 8 };
+    return vaddvq_u32(vandq_u32(m.v, weights));
+  }
+  static F Sqrt(F x) { return { vsqrtq_f32(x.v) }; }
+  static F Min(F a, F b) { return { vminq_f32(a.v, b.v) }; }
+  static F Max(F a, F b) { return { vmaxq_f32(a.v, b.v) }; }
+  static F Abs(F x) { return { vabsq_f32(x.v) }; }
+  static F Select(M m, F a, F b) { return { vbslq_f32(m.v, a.v, b.v) }; }
+  static M AndNot(M a, M b) { return { vbicq_u32(b.v, a.v) }; }
+
+  static U SetU(uint32_t x) { return { vdupq_n_u32(x) }; }
+  static U LoadU(const uint32_t* p) { return { vld1q_u32(p) }; }
+  static void StoreU(uint32_t* p, U x) { vst1q_u32(p, x.v); }
+  static void MulWide(U a, U b, U& hi, U& lo) {
+    // Widening products of the low and high lane pairs, then split into 32-bit halves
+    uint32x4_t low = vreinterpretq_u32_u64(vmull_u32(vget_low_u32(a.v), vget_low_u32(b.v)));
+    uint32x4_t high = vreinterpretq_u32_u64(vmull_high_u32(a.v, b.v));
+    lo = { vuzp1q_u32(low, high) };
+    hi = { vuzp2q_u32(low, high) };
+  }
+  static M Nonzero(U x) { return { vtstq_u32(x.v, x.v) }; }
+  static U RoundToInt(F x) { return { vreinterpretq_u32_s32(vcvtnq_s32_f32(x.v)) }; }
+  static F ToFloat(U x) { return { vcvtq_f32_s32(vreinterpretq_s32_u32(x.v)) }; }
+  static F ToUnit(U x) { return { vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(x.v, 8)), vdupq_n_f32(1.0f / 16777216.0f)) }; }
+};
+
+inline NEON::F operator+(NEON::F a, NEON::F b) { return { vaddq_f32(a.v, b.v) }; }
+inline NEON::F operator-(NEON::F a, NEON::F b) { return { vsubq_f32(a.v, b.v) }; }
+inline NEON::F operator*(NEON::F a, NEON::F b) { return { vmulq_f32(a.v, b.v) }; }
+inline NEON::F operator/(NEON::F a, NEON::F b) { return { vdivq_f32(a.v, b.v) }; }
+inline NEON::M operator<(NEON::F a, NEON::F b) { return { vcltq_f32(a.v, b.v) }; }
+inline NEON::M operator<=(NEON::F a, NEON::F b) { return { vcleq_f32(a.v, b.v) }; }
+inline NEON::M operator>(NEON::F a, NEON::F b) { return { vcgtq_f32(a.v, b.v) }; }
+inline NEON::M operator&(NEON::M a, NEON::M b) { return { vandq_u32(a.v, b.v) }; }
+inline NEON::M operator|(NEON::M a, NEON::M b) { return { vorrq_u32(a.v, b.v) }; }
+inline NEON::U operator+(NEON::U a, NEON::U b) { return { vaddq_u32(a.v, b.v) }; }
+inline NEON::U operator^(NEON::U a, NEON::U b) { return { veorq_u32(a.v, b.v) }; }
+inline NEON::U operator&(NEON::U a, NEON::U b) { return { vandq_u32(a.v, b.v) }; }
+
+}  // namespace
+
+void GeodesicStepNEON(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params) {
+  GeodesicStepSimd<NEON>(rays, begin, end, params);
+}
+
+bool LightFieldResolveNEON(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params) {
+  return LightFieldResolveSimd<NEON>(row, count, params);
+}
+
+void RayResetNEON(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params) {
+  RayResetSimd<NEON>(lanes, begin, end, params);
+}
+#endif
@@ -0,0 +1,86 @@
+// SSE4.1 geodesic step, light field resolve and ray reset kernels: 4 lanes per instruction.
+// Built with SSE4.1 enabled; only called after CPUID confirms support.
+#include "GeodesicKernelSimd.h"
+#include "LightFieldKernelSimd.h"
+#include "RayResetKernelSimd.h"
+
+#if defined(OPENGLFW_SIMD_X86)
+#include <smmintrin.h>
+#include <cstring>
+
+namespace {
+
+struct SSE41 {
+  static constexpr size_t Width = 4;
+  struct F { __m128 v; };
+  struct M { __m128 v; };
+  struct U { __m128i v; };
+
+  static F Set(float x) { return { _mm_set1_ps(x) }; }
+  static F Load(const float* p) { return { _mm_loadu_ps(p) }; }
+  static void Store(float* p, F x) { _mm_storeu_ps(p, x.v); }
+  static M LoadMask(const uint8_t* p) {
+    int bytes;
+    std::memcpy(&bytes, p, sizeof(bytes));
+    __m128i lanes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+    return { _mm_castsi128_ps(_mm_cmpgt_epi32(lanes, _mm_setzero_si128())) };
+  }
+  static unsigned Bits(M m) { return static_cast<unsigned>(_mm_movemask_ps(m.v)); }
+  static F Sqrt(F x) { return { _mm_sqrt_ps(x.v) }; }
+  static F Min(F a, F b) { return { _mm_min_ps(a.v, b.v) }; }
+  static F Max(F a, F b) { return { _mm_max_ps(a.v, b.v) }; }
+  static F Abs(F x) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), x.v) }; }
+  static F Select(M m, F a, F b) { return { _mm_blendv_ps(b.v, a.v, m.v) }; }
+  static M AndNot(M a, M b) { return { _mm_andnot_ps(a.v, b.v) }; }
+
+  static U SetU(uint32_t x) { return { _mm_set1_epi32(static_cast<int>(x)) }; }
+  static U LoadU(const uint32_t* p) { return { _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) }; }
+  static void StoreU(uint32_t* p, U x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x.v); }
+  static void MulWide(U a, U b, U& hi, U& lo) {
+    // Even lanes, then odd lanes moved down; each product fills a 64-bit half
+    __m128i even = _mm_mul_epu32(a.v, b.v);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32));
+    lo = { _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC) };
+    hi = { _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC) };
+  }
+  static M Nonzero(U x) {
+    __m128i zero = _mm_cmpeq_epi32(x.v, _mm_setzero_si128());
+    return { _mm_castsi128_ps(_mm_xor_si128(zero, _mm_set1_epi32(-1))) };
+  }
+  static U RoundToInt(F x) { return { _mm_cvtps_epi32(x.v) }; }
+  static F ToFloat(U x) { return { _mm_cvtepi32_ps(x.v) }; }
+  static F ToUnit(U x) {
+    __m128 top = _mm_cvtepi32_ps(_mm_srli_epi32(x.v, 8));
+    return { _mm_mul_ps(top, _mm_set1_ps(1.0f / 16777216.0f)) };
+  }
+};
+
+inline SSE41::F operator+(SSE41::F a, SSE41::F b) { return { _mm_add_ps(a.v, b.v) }; }
+inline SSE41::F operator-(SSE41::F a, SSE41::F b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline SSE41::F operator*(SSE41::F a, SSE41::F b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline SSE41::F operator/(SSE41::F a, SSE41::F b) { return { _mm_div_ps(a.v, b.v) }; }
+inline SSE41::M operator<(SSE41::F a, SSE41::F b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline SSE41::M operator<=(SSE41::F a, SSE41::F b) { return { _mm_cmple_ps(a.v, b.v) }; }
+inline SSE41::M operator>(SSE41::F a, SSE41::F b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+inline SSE41::M operator&(SSE41::M a, SSE41::M b) { return { _mm_and_ps(a.v, b.v) }; }
+inline SSE41::M operator|(SSE41::M a, SSE41::M b) { return { _mm_or_ps(a.v, b.v) }; }
+inline SSE41::U operator+(SSE41::U a, SSE41::U b) { return { _mm_add_epi32(a.v, b.v) }; }
+inline SSE41::U operator^(SSE41::U a, SSE41::U b) { return { _mm_xor_si128(a.v, b.v) }; }
+inline SSE41::U operator&(SSE41::U a, SSE41::U b) { return { _mm_and_si128(a.v, b.v) }; }
+
+}  // namespace
+
+void GeodesicStepSSE41(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params) {
+  GeodesicStepSimd<SSE41>(rays, begin, end, params);
+}
+
+bool LightFieldResolveSSE41(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params) {
+  return LightFieldResolveSimd<SSE41>(row, count, params);
+}
+
+void RayResetSSE41(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params) {
+  RayResetSimd<SSE41>(lanes, begin, end, params);
+}
+#endif
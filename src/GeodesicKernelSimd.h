@@ -0,0 +1,146 @@
+#pragma once
+
+// Width-generic geodesic step kernel.
+// Each instruction-set translation unit defines a vector type V in an
+// anonymous namespace and instantiates GeodesicStepSimd<V>; only templates
+// live here so no ISA-specific code leaks into other translation units.
+
+#include "GeodesicKernel.h"
+
+#if defined(OPENGLFW_SIMD_X86)
+void GeodesicStepSSE41(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params);
+void GeodesicStepAVX2(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params);
+void GeodesicStepAVX512(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params);
+#endif
+
+#if defined(OPENGLFW_SIMD_NEON)
+void GeodesicStepNEON(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params);
+#endif
+
+// V provides:
+//   V::Width, V::F (float lanes), V::M (lane mask)
+//   Set, Load, Store, LoadMask (from bytes), Bits (mask -> lane bits)
+//   Sqrt, Min, Max, Abs, Select(m, ifTrue, ifFalse), AndNot(a, b) = ~a & b
+//   operators + - * / on F, < <= > on F, & | on M
+template <typename V>
+void GeodesicStepSimd(const GeodesicStepArrays& rays, size_t begin, size_t end,
+  const GeodesicStepParams& params) {
+  using F = typename V::F;
+  using M = typename V::M;
+
+  const F dt = V::Set(params.deltaTime);
+  const F bx = V::Set(params.blackholeX);
+  const F by = V::Set(params.blackholeY);
+  const F rs = V::Set(2.0f * params.blackholeMass);  // Schwarzschild radius
+  const F halfRs = V::Set(2.0f * params.blackholeMass * 0.5f);
+  const F eventHorizon = V::Set(params.eventHorizon);
+  const F gravity = V::Set(params.gravityMultiplier);
+  const F maxForce = V::Set(params.maxForce);
+  const F minDistance = V::Set(params.minDistance);
+  const F zero = V::Set(0.0f);
+  const F one = V::Set(1.0f);
+  const F two = V::Set(2.0f);
+  const F tenth = V::Set(0.1f);
+  const F frozenDilation = V::Set(0.01f);
+  const F maxDilation = V::Set(10.0f);
+  const F minSpeed = V::Set(0.001f);
+
+  size_t i = begin;
+  for (; i + V::Width <= end; i += V::Width) {
+    M active = V::LoadMask(rays.mask + i);
+    M wasAbsorbed = V::LoadMask(rays.absorbed + i);
+    M moving = V::AndNot(wasAbsorbed, active);
+    if (V::Bits(active) == 0) continue;
+
+    // Absorbed rays only advance their absorption timer
+    F timer = V::Load(rays.absorbTimer + i);
+    timer = V::Select(active & wasAbsorbed, timer + dt, timer);
+    if (V::Bits(moving) == 0) {
+      V::Store(rays.absorbTimer + i, timer);
+      continue;
+    }
+
+    F px = V::Load(rays.posX + i);
+    F py = V::Load(rays.posY + i);
+    F vx0 = V::Load(rays.velX + i);
+    F vy0 = V::Load(rays.velY + i);
+    F pt = V::Load(rays.properTime + i);
+    F L = V::Load(rays.angularMomentum + i);
+
+    F tx = bx - px;
+    F ty = by - py;
+    F r = V::Sqrt(tx * tx + ty * ty);
+
+    // Time dilation: dt/dtau = 1/sqrt(1 - rs/r), nearly frozen inside rs
+    F dilation = V::Min(one / V::Sqrt(one - rs / r), maxDilation);
+    dilation = V::Select(r <= rs, frozenDilation, dilation);
+    F edt = dt / dilation;
+
+    // Strong field: pull straight toward the hole at the force cap
+    F invR = one / r;
+    F strongX = tx * invR * maxForce;
+    F strongY = ty * invR * maxForce;
+
+    // Weak field: radial and tangential Schwarzschild components
+    F rc = V::Max(r, minDistance);
+    F rHatX = tx / rc;
+    F rHatY = ty / rc;
+    F radial = (zero - rs / (two * rc * rc)) * (one - rs / rc);
+    F tangential = (zero - rs / (rc * rc * rc)) * V::Abs(L) * tenth;
+    F ax = (radial * rHatX + tangential * (zero - rHatY)) * gravity;
+    F ay = (radial * rHatY + tangential * rHatX) * gravity;
+
+    // Cap the maximum acceleration
+    F accel = V::Sqrt(ax * ax + ay * ay);
+    M capped = accel > maxForce;
+    ax = V::Select(capped, ax / accel * maxForce, ax);
+    ay = V::Select(capped, ay / accel * maxForce, ay);
+
+    M strong = rc < halfRs;
+    ax = V::Select(strong, strongX, ax);
+    ay = V::Select(strong, strongY, ay);
+
+    // Only direction changes; light always travels at its base speed
+    F nvx = vx0 + ax * edt;
+    F nvy = vy0 + ay * edt;
+    F newSpeed = V::Sqrt(nvx * nvx + nvy * nvy);
+    F invSpeed = one / newSpeed;
+    F baseSpeed = V::Load(rays.speed + i);
+    M renormalize = newSpeed > minSpeed;
+    F vx = V::Select(renormalize, nvx * invSpeed * baseSpeed, vx0);
+    F vy = V::Select(renormalize, nvy * invSpeed * baseSpeed, vy0);
+
+    F nx = px + vx * edt;
+    F ny = py + vy * edt;
+    F newL = nx * vy - ny * vx;
+
+    // Freeze at the event horizon once crossed
+    M captured = moving & (r < eventHorizon);
+    F ux = bx - nx;
+    F uy = by - ny;
+    F invU = one / V::Sqrt(ux * ux + uy * uy);
+    nx = V::Select(captured, bx - ux * invU * eventHorizon, nx);
+    ny = V::Select(captured, by - uy * invU * eventHorizon, ny);
+    timer = V::Select(captured, zero, timer);
+
+    V::Store(rays.posX + i, V::Select(moving, nx, px));
+    V::Store(rays.posY + i, V::Select(moving, ny, py));
+    V::Store(rays.velX + i, V::Select(moving, vx, vx0));
+    V::Store(rays.velY + i, V::Select(moving, vy, vy0));
+    V::Store(rays.angularMomentum + i, V::Select(moving, newL, L));
+    V::Store(rays.properTime + i, V::Select(moving, pt + edt, pt));
+    V::Store(rays.absorbTimer + i, timer);
+
+    unsigned capturedBits = V::Bits(captured);
+    for (size_t lane = 0; capturedBits != 0; ++lane, capturedBits >>= 1) {
+      if (capturedBits & 1) rays.absorbed[i + lane] = 1;
+    }
+  }
+
+  // Remainder that does not fill a vector
+  GeodesicStepScalar(rays, i, end, params);
+}
@@ -0,0 +1,192 @@
+#include "Integrators.h"
+#include "LightRay.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Photon state advanced in coordinate (frame) time
+struct PhotonState {
+  glm::vec2 position;
+  glm::vec2 velocity;
+  float properTime;
+};
+
+PhotonState operator+(const PhotonState& a, const PhotonState& b) {
+  return { a.position + b.position, a.velocity + b.velocity, a.properTime + b.properTime };
+}
+
+PhotonState operator*(const PhotonState& s, float h) {
+  return { s.position * h, s.velocity * h, s.properTime * h };
+}
+
+// Rates of change per unit frame time; time dilation slows both position and velocity.
+// Light only changes direction, so the deflection along the velocity is dropped: the
+// equations then keep the speed themselves instead of relying on the renormalization
+// after each step, which would cap every scheme at first order.
+PhotonState Derivative(const PhotonState& s, const GeodesicStepParams& p) {
+  glm::vec2 blackholePos(p.blackholeX, p.blackholeY);
+  float r = glm::length(s.position - blackholePos);
+  float invDilation = 1.0f / LightRay::CalculateTimeDilation(r, p.blackholeMass);
+  float angularMomentum = s.position.x * s.velocity.y - s.position.y * s.velocity.x;
+  glm::vec2 acceleration = LightRay::CalculateGeodesicDeflection(s.position, s.velocity,
+    blackholePos, p.blackholeMass, angularMomentum, p.gravityMultiplier, p.maxForce, p.minDistance);
+  float speedSquared = glm::dot(s.velocity, s.velocity);
+  if (speedSquared > 1e-6f) {
+    acceleration -= s.velocity * (glm::dot(acceleration, s.velocity) / speedSquared);
+  }
+  return { s.velocity * invDilation, acceleration * invDilation, invDilation };
+}
+
+// Light always travels at its base speed: project velocity back onto that shell
+void Renormalize(PhotonState& s, float speed) {
+  float currentSpeed = glm::length(s.velocity);
+  if (currentSpeed > 0.001f) {
+    s.velocity = s.velocity / currentSpeed * speed;
+  }
+}
+
+PhotonState StepLeapfrog(const PhotonState& s, float h, const GeodesicStepParams& p) {
+  // Kick (half step), drift (full step), kick (half step)
+  PhotonState k0 = Derivative(s, p);
+  PhotonState next = s;
+  next.velocity += k0.velocity * (0.5f * h);
+  next.position += next.velocity * (k0.properTime * h);
+
+  PhotonState k1 = Derivative(next, p);
+  next.velocity += k1.velocity * (0.5f * h);
+  next.properTime += 0.5f * h * (k0.properTime + k1.properTime);
+  return next;
+}
+
+PhotonState StepRK4(const PhotonState& s, float h, const GeodesicStepParams& p) {
+  PhotonState k1 = Derivative(s, p);
+  PhotonState k2 = Derivative(s + k1 * (0.5f * h), p);
+  PhotonState k3 = Derivative(s + k2 * (0.5f * h), p);
+  PhotonState k4 = Derivative(s + k3 * h, p);
+  return s + (k1 + k2 * 2.0f + k3 * 2.0f + k4) * (h / 6.0f);
+}
+
+// Dormand-Prince 5(4) step; returns the fifth-order solution and writes the error estimate
+PhotonState StepRK45(const PhotonState& s, float h, const GeodesicStepParams& p,
+  PhotonState& error) {
+  PhotonState k1 = Derivative(s, p);
+  PhotonState k2 = Derivative(s + k1 * (h / 5.0f), p);
+  PhotonState k3 = Derivative(s + (k1 * (3.0f / 40.0f) + k2 * (9.0f / 40.0f)) * h, p);
+  PhotonState k4 = Derivative(s + (k1 * (44.0f / 45.0f) + k2 * (-56.0f / 15.0f)
+    + k3 * (32.0f / 9.0f)) * h, p);
+  PhotonState k5 = Derivative(s + (k1 * (19372.0f / 6561.0f) + k2 * (-25360.0f / 2187.0f)
+    + k3 * (64448.0f / 6561.0f) + k4 * (-212.0f / 729.0f)) * h, p);
+  PhotonState k6 = Derivative(s + (k1 * (9017.0f / 3168.0f) + k2 * (-355.0f / 33.0f)
+    + k3 * (46732.0f / 5247.0f) + k4 * (49.0f / 176.0f) + k5 * (-5103.0f / 18656.0f)) * h, p);
+
+  PhotonState next = s + (k1 * (35.0f / 384.0f) + k3 * (500.0f / 1113.0f) + k4 * (125.0f / 192.0f)
+    + k5 * (-2187.0f / 6784.0f) + k6 * (11.0f / 84.0f)) * h;
+  PhotonState k7 = Derivative(next, p);
+
+  // Difference between the fifth- and fourth-order weights
+  error = (k1 * (71.0f / 57600.0f) + k3 * (-71.0f / 16695.0f) + k4 * (71.0f / 1920.0f)
+    + k5 * (-17253.0f / 339200.0f) + k6 * (22.0f / 525.0f) + k7 * (-1.0f / 40.0f)) * h;
+  return next;
+}
+
+}  // namespace
+
+void IntegrateRays(IntegratorType type, const GeodesicStepArrays& rays, float* stepSize,
+  size_t begin, size_t end, const GeodesicStepParams& params, const IntegratorSettings& settings) {
+  glm::vec2 blackholePos(params.blackholeX, params.blackholeY);
+  float deltaTime = params.deltaTime;
+
+  for (size_t i = begin; i < end; ++i) {
+    if (!rays.mask[i]) continue;
+
+    // Absorbed rays only advance their absorption timer
+    if (rays.absorbed[i]) {
+      rays.absorbTimer[i] += deltaTime;
+      continue;
+    }
+
+    PhotonState state = {
+      glm::vec2(rays.posX[i], rays.posY[i]),
+      glm::vec2(rays.velX[i], rays.velY[i]),
+      rays.properTime[i]
+    };
+    float speed = rays.speed[i];
+    bool captured = glm::length(state.position - blackholePos) < params.eventHorizon;
+
+    if (!captured && type == IntegratorType::RK45) {
+      // Adaptive sub-steps: large in weak fields, small near the photon sphere
+      float h = stepSize[i] > 0.0f ? stepSize[i] : deltaTime;
+      float elapsed = 0.0f;
+      for (int substep = 0; substep < settings.maxSubsteps && elapsed < deltaTime; ++substep) {
+        float step = std::min(h, deltaTime - elapsed);
+        PhotonState error;
+        PhotonState next = StepRK45(state, step, params, error);
+
+        float positionError = glm::length(error.position) / settings.tolerance;
+        float velocityError = glm::length(error.velocity) / (settings.tolerance * std::max(speed, 0.001f));
+        float errorNorm = std::max(positionError, velocityError);
+
+        // Grow or shrink the next step from the error estimate
+        float factor = errorNorm > 0.0f ? 0.9f * std::pow(errorNorm, -0.2f) : 5.0f;
+        factor = std::clamp(factor, 0.2f, 5.0f);
+
+        if (errorNorm <= 1.0f || step <= settings.minStep) {
+          state = next;
+          Renormalize(state, speed);
+          elapsed += step;
+          // Keep the proposed step unless this one was clipped by the end of the frame
+          if (step == h || factor < 1.0f) h = std::max(step * factor, settings.minStep);
+          if (glm::length(state.position - blackholePos) < params.eventHorizon) {
+            captured = true;
+            break;
+          }
+        }
+        else {
+          h = std::max(step * factor, settings.minStep);
+        }
+      }
+      stepSize[i] = h;
+
+      // Out of sub-steps: finish the frame with one fixed step so the ray never stalls
+      if (!captured && elapsed < deltaTime) {
+        state = StepRK4(state, deltaTime - elapsed, params);
+        Renormalize(state, speed);
+      }
+    }
+    else if (!captured) {
+      state = type == IntegratorType::Leapfrog
+        ? StepLeapfrog(state, deltaTime, params)
+        : StepRK4(state, deltaTime, params);
+      Renormalize(state, speed);
+    }
+
+    if (!captured) {
+      captured = glm::length(state.position - blackholePos) < params.eventHorizon;
+    }
+
+    // Freeze at the event horizon once crossed
+    if (captured) {
+      rays.absorbed[i] = 1;
+      rays.absorbTimer[i] = 0.0f;
+      state.position = blackholePos - glm::normalize(blackholePos - state.position) * params.eventHorizon;
+    }
+
+    rays.posX[i] = state.position.x;
+    rays.posY[i] = state.position.y;
+    rays.velX[i] = state.velocity.x;
+    rays.velY[i] = state.velocity.y;
+    rays.properTime[i] = state.properTime;
+    rays.angularMomentum[i] = state.position.x * state.velocity.y - state.position.y * state.velocity.x;
+  }
+}
+
+const char* IntegratorName(IntegratorType type) {
+  switch (type) {
+  case IntegratorType::Leapfrog: return "Leapfrog";
+  case IntegratorType::RK4: return "RK4";
+  case IntegratorType::RK45: return "RK45 (adaptive)";
+  default: return "Euler";
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "GeodesicKernel.h"
+
+// Integration scheme used to advance photons each frame
+enum class IntegratorType {
+  Euler,     // One explicit step per frame (vectorized kernel)
+  Leapfrog,  // Kick-drift-kick, symplectic
+  RK4,       // Classic fourth-order Runge-Kutta
+  RK45       // Dormand-Prince 5(4) with adaptive sub-steps
+};
+
+static const int INTEGRATOR_COUNT = 4;
+
+// Tuning for the adaptive integrator
+struct IntegratorSettings {
+  float tolerance = 1e-4f;  // Allowed local error per sub-step (world units)
+  float minStep = 1e-4f;    // Smallest sub-step before accepting regardless of error
+  int maxSubsteps = 64;     // Cap on sub-steps per ray per frame
+};
+
+// Closed-form propagation far from the hole (see RayBatch::CoastRays)
+struct WeakFieldSettings {
+  bool enabled = true;
+  float switchRadius = 1.0f;   // Full integration inside this distance from the hole
+  float tolerance = 1e-3f;     // Allowed position error per closed-form window (world units)
+  float maxWindow = 2.0f;      // Longest window before re-anchoring (seconds)
+};
+
+// Advance rays [begin, end) by params.deltaTime with a non-Euler scheme.
+// stepSize holds each ray's last accepted adaptive step (0 = start from the frame step).
+void IntegrateRays(IntegratorType type, const GeodesicStepArrays& rays, float* stepSize,
+  size_t begin, size_t end, const GeodesicStepParams& params, const IntegratorSettings& settings);
+
+// Human-readable name of a scheme
+const char* IntegratorName(IntegratorType type);
@@ -1,143 +1,183 @@
 #include "LightFieldGrid.h"
-#include <glad/glad.h>
 #include <algorithm>
 #include <cmath>
 
-LightFieldGrid::LightFieldGrid()
-  : decayRate(0.985f)      // Slow fade for trail effect
+LightFieldGrid::LightFieldGrid(int cells, bool sparseTiles)
+  : resolution(std::max(cells, 1))
+  , sparse(sparseTiles)
+  , shardStride(0)
+  , shardCount(0)
+  , pathLengthWeighting(false)
+  , tilesPerSide((resolution + TILE_SIZE - 1) / TILE_SIZE)
+  , displayFrame(0)
+  , decayRate(0.985f)      // Slow fade for trail effect
   , maxBrightness(5.0f)    // Cap brightness to prevent oversaturation
   , displayThreshold(0.05f) // Don't display cells below 5% intensity
   , worldSize(4.0f)        // World spans from -2 to 2
-  , VAO(0)
-  , VBO(0)
-  , EBO(0) {
-
-  // Initialize grid with zeros
-  grid.resize(GRID_SIZE);
-  for (int i = 0; i < GRID_SIZE; i++) {
-    grid[i].resize(GRID_SIZE, 0.0f);
-  }
-}
-
-LightFieldGrid::~LightFieldGrid() {
-  if (VAO) glDeleteVertexArrays(1, &VAO);
-  if (VBO) glDeleteBuffers(1, &VBO);
-  if (EBO) glDeleteBuffers(1, &EBO);
-}
-
-bool LightFieldGrid::Initialize() {
-  // Create vertex data for grid cells
-  // Each cell is a quad (4 vertices)
-  vertices.clear();
-  indices.clear();
-
-  float cellSize = worldSize / GRID_SIZE;
-
-  // Reserve space
-  vertices.reserve(GRID_SIZE * GRID_SIZE * 4 * 5); // 4 verts * 5 floats per cell
-  indices.reserve(GRID_SIZE * GRID_SIZE * 6);      // 2 triangles * 3 indices per cell
-
-  // Generate vertices and indices for all cells
-  for (int y = 0; y < GRID_SIZE; y++) {
-    for (int x = 0; x < GRID_SIZE; x++) {
-      float worldX = -worldSize / 2.0f + x * cellSize;
-      float worldY = -worldSize / 2.0f + y * cellSize;
-
-      int baseIndex = (y * GRID_SIZE + x) * 4;
-
-      // Add 4 vertices for this cell (positions + colors)
-      // Bottom left
-      vertices.push_back(worldX);
-      vertices.push_back(worldY);
-      vertices.push_back(0.0f); // R
-      vertices.push_back(0.0f); // G
-      vertices.push_back(0.0f); // B
-
-      // Bottom right
-      vertices.push_back(worldX + cellSize);
-      vertices.push_back(worldY);
-      vertices.push_back(0.0f);
-      vertices.push_back(0.0f);
-      vertices.push_back(0.0f);
-
-      // Top right
-      vertices.push_back(worldX + cellSize);
-      vertices.push_back(worldY + cellSize);
-      vertices.push_back(0.0f);
-      vertices.push_back(0.0f);
-      vertices.push_back(0.0f);
-
-      // Top left
-      vertices.push_back(worldX);
-      vertices.push_back(worldY + cellSize);
-      vertices.push_back(0.0f);
-      vertices.push_back(0.0f);
-      vertices.push_back(0.0f);
-
-      // Add indices for 2 triangles
-      indices.push_back(baseIndex);
-      indices.push_back(baseIndex + 1);
-      indices.push_back(baseIndex + 2);
-
-      indices.push_back(baseIndex);
-      indices.push_back(baseIndex + 2);
-      indices.push_back(baseIndex + 3);
+  , lazyDecay(false)
+  , step(0)
+  , resolveKernel(GetLightFieldResolveKernel(DetectSimdLevel())) {
+
+  // Initialize grid with zeros: a dense grid owns every tile from the start
+  shardStride = GetTileCount() * TILE_CELLS;
+  tiles.resize(GetTileCount());
+  if (!sparse) {
+    for (size_t t = 0; t < tiles.size(); t++) AcquireTile(t);
+  }
+  BuildDecayPowers();
+
+  // Everything starts black, matching the cleared texture
+  trackedThreshold = displayThreshold;
+  tileVisible.assign(GetTileCount(), 0);
+  tileChangeFrames.assign(GetTileCount(), 0);
+  tileFadedStep.assign(GetTileCount(), NOT_FADED);
+}
+
+void LightFieldGrid::Clear() {
+  for (std::unique_ptr<TileBlock>& block : tiles) {
+    if (!block) continue;
+    if (sparse) {
+      freeBlocks.push_back(std::move(block));
+    }
+    else {
+      *block = TileBlock();
     }
   }
+  std::fill(shards.begin(), shards.end(), 0u);
+  step = 0;
+  std::fill(tileFadedStep.begin(), tileFadedStep.end(), NOT_FADED);
+}
 
-  // Create OpenGL objects
-  glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
-  glGenBuffers(1, &EBO);
+LightFieldGrid::TileBlock& LightFieldGrid::AcquireTile(size_t tile) {
+  std::unique_ptr<TileBlock>& block = tiles[tile];
+  if (block) return *block;
 
-  glBindVertexArray(VAO);
+  {
+    std::lock_guard<std::mutex> lock(freeBlocksMutex);
+    if (!freeBlocks.empty()) {
+      block = std::move(freeBlocks.back());
+      freeBlocks.pop_back();
+    }
+  }
+  if (block) {
+    *block = TileBlock();
+  }
+  else {
+    block = std::make_unique<TileBlock>();
+  }
+  return *block;
+}
 
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
-    vertices.data(), GL_DYNAMIC_DRAW);
+void LightFieldGrid::ReleaseIfFaded(size_t tile) {
+  std::unique_ptr<TileBlock>& block = tiles[tile];
+  if (!sparse || !block) return;
 
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
-    indices.data(), GL_STATIC_DRAW);
+  float brightest = 0.0f;
+  for (int i = 0; i < TILE_CELLS; i++) {
+    brightest = std::max(brightest, block->cells[i]);
+  }
+  if (brightest >= displayThreshold) return;
 
-  // Position attribute
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-  glEnableVertexAttribArray(0);
+  std::lock_guard<std::mutex> lock(freeBlocksMutex);
+  freeBlocks.push_back(std::move(block));
+}
 
-  // Color attribute
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
-    (void*)(2 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+size_t LightFieldGrid::GetAllocatedTileCount() const {
+  return static_cast<size_t>(std::count_if(tiles.begin(), tiles.end(),
+    [](const std::unique_ptr<TileBlock>& block) { return block != nullptr; }));
+}
 
-  glBindVertexArray(0);
+void LightFieldGrid::BeginStep() {
+  if (lazyDecay) {
+    step++;
+    return;
+  }
+  for (std::unique_ptr<TileBlock>& block : tiles) {
+    if (block) std::copy(block->cells, block->cells + TILE_CELLS, block->previous);
+  }
+}
 
-  return true;
+void LightFieldGrid::SetDecayRate(float rate) {
+  decayRate = rate;
+  BuildDecayPowers();
 }
 
-void LightFieldGrid::Clear() {
-  for (int y = 0; y < GRID_SIZE; y++) {
-    for (int x = 0; x < GRID_SIZE; x++) {
-      grid[y][x] = 0.0f;
+void LightFieldGrid::BuildDecayPowers() {
+  // decayRate^k until it no longer matters (capped for rates close to 1);
+  // larger k use the last entry, which is zero once everything has faded
+  const size_t maxSteps = 4096;
+  decayPowers.assign(1, 1.0f);
+  while (decayPowers.size() < maxSteps && decayPowers.back() >= 1e-6f) {
+    decayPowers.push_back(decayPowers.back() * decayRate);
+  }
+  if (decayPowers.back() < 1e-6f) decayPowers.back() = 0.0f;
+}
+
+float LightFieldGrid::DecayedBy(float value, uint32_t steps) const {
+  value *= decayPowers[std::min<size_t>(steps, decayPowers.size() - 1)];
+  return value < FLUSH_BELOW ? 0.0f : value;
+}
+
+float& LightFieldGrid::TouchCell(TileBlock& block, size_t cell) {
+  float& value = block.cells[cell];
+  if (lazyDecay && block.lastStep[cell] < step) {
+    // First write this step: catch up on the decay since the last one, and keep the
+    // result as the blend origin for display
+    value = DecayedBy(value, step - block.lastStep[cell]);
+    block.previous[cell] = value;
+    block.lastStep[cell] = step;
+    block.writtenStep = step;
+  }
+  return value;
+}
+
+void LightFieldGrid::SetLazyDecay(bool enabled) {
+  if (enabled == lazyDecay) return;
+  lazyDecay = enabled;
+
+  for (std::unique_ptr<TileBlock>& block : tiles) {
+    if (!block) continue;
+
+    if (enabled) {
+      // The grid already holds this step's decayed values: stamp every cell one step
+      // ahead so no further decay is applied until the next step begins
+      std::copy(block->cells, block->cells + TILE_CELLS, block->previous);
+      std::fill(block->lastStep, block->lastStep + TILE_CELLS, step + 1);
+      block->writtenStep = step + 1;
+      continue;
+    }
+
+    // Back to eager decay: write out every cell's current and previous value
+    for (int i = 0; i < TILE_CELLS; i++) {
+      uint32_t last = block->lastStep[i];
+      if (last < step) block->previous[i] = DecayedBy(block->cells[i], step - last);
+      block->cells[i] = DecayedBy(block->cells[i], step + 1 - last);
     }
   }
 }
 
-glm::ivec2 LightFieldGrid::WorldToGrid(glm::vec2 worldPos) const {
-  // Convert world coordinates (-2 to 2) to grid coordinates (0 to GRID_SIZE-1)
+glm::vec2 LightFieldGrid::WorldToGridPoint(glm::vec2 worldPos) const {
+  // Convert world coordinates (-2 to 2) to grid coordinates (0 to resolution)
   float normalizedX = (worldPos.x + worldSize / 2.0f) / worldSize;
   float normalizedY = (worldPos.y + worldSize / 2.0f) / worldSize;
+  return glm::vec2(normalizedX * resolution, normalizedY * resolution);
+}
 
-  int gridX = (int)(normalizedX * GRID_SIZE);
-  int gridY = (int)(normalizedY * GRID_SIZE);
+glm::ivec2 LightFieldGrid::WorldToGrid(glm::vec2 worldPos) const {
+  // Cell containing the point (0 to resolution-1)
+  glm::vec2 point = WorldToGridPoint(worldPos);
+  int gridX = (int)point.x;
+  int gridY = (int)point.y;
 
   // Clamp to grid bounds
-  gridX = std::max(0, std::min(GRID_SIZE - 1, gridX));
-  gridY = std::max(0, std::min(GRID_SIZE - 1, gridY));
+  gridX = std::max(0, std::min(resolution - 1, gridX));
+  gridY = std::max(0, std::min(resolution - 1, gridY));
 
   return glm::ivec2(gridX, gridY);
 }
 
-void LightFieldGrid::AccumulateLineBresenham(int x0, int y0, int x1, int y1, float intensity) {
+void LightFieldGrid::AccumulateLineClipped(int x0, int y0, int x1, int y1, float intensity,
+  int minX, int minY, int maxX, int maxY) {
   // Bresenham's line algorithm to accumulate intensity along a line
   int dx = abs(x1 - x0);
   int dy = abs(y1 - y0);
@@ -147,9 +187,9 @@ void LightFieldGrid::AccumulateLineBresenham(int x0, int y0, int x1, int y1, flo
 
   while (true) {
     // Check bounds and accumulate
-    if (x0 >= 0 && x0 < GRID_SIZE && y0 >= 0 && y0 < GRID_SIZE) {
-      grid[y0][x0] += intensity;
-      grid[y0][x0] = std::min(grid[y0][x0], maxBrightness);
+    if (x0 >= minX && x0 < maxX && y0 >= minY && y0 < maxY) {
+      float& cell = TouchCell(AcquireTile(TileIndex(x0, y0)), LocalIndex(x0, y0));
+      cell = std::min(cell + intensity, maxBrightness);
     }
 
     if (x0 == x1 && y0 == y1) break;
@@ -166,103 +206,421 @@ void LightFieldGrid::AccumulateLineBresenham(int x0, int y0, int x1, int y1, flo
   }
 }
 
+// Parameter t at which origin + t * direction reaches bound. Both the clip and the walk
+// use this one expression, so a walk clipped to a tile meets every cell boundary at
+// the same t as a walk over the whole grid.
+static float Crossing(float bound, float origin, float direction) {
+  return (bound - origin) / direction;
+}
+
+template <typename Deposit>
+void LightFieldGrid::WalkPathLength(glm::vec2 a, glm::vec2 b, int minX, int minY, int maxX, int maxY,
+  Deposit deposit) {
+  glm::vec2 d = b - a;
+  float length = glm::length(d);
+  if (length <= 0.0f) return;
+
+  // Clip the parameter range to the box (Liang-Barsky)
+  float t0 = 0.0f;
+  float t1 = 1.0f;
+  if (d.x == 0.0f) {
+    if (a.x < minX || a.x >= maxX) return;
+  }
+  else {
+    float tLow = Crossing(static_cast<float>(minX), a.x, d.x);
+    float tHigh = Crossing(static_cast<float>(maxX), a.x, d.x);
+    t0 = std::max(t0, std::min(tLow, tHigh));
+    t1 = std::min(t1, std::max(tLow, tHigh));
+  }
+  if (d.y == 0.0f) {
+    if (a.y < minY || a.y >= maxY) return;
+  }
+  else {
+    float tLow = Crossing(static_cast<float>(minY), a.y, d.y);
+    float tHigh = Crossing(static_cast<float>(maxY), a.y, d.y);
+    t0 = std::max(t0, std::min(tLow, tHigh));
+    t1 = std::min(t1, std::max(tLow, tHigh));
+  }
+  if (t0 >= t1) return;
+
+  // Next boundary crossed along each axis from cell (x, y); never for axis-parallel segments
+  int stepX = d.x > 0.0f ? 1 : -1;
+  int stepY = d.y > 0.0f ? 1 : -1;
+  auto nextX = [&](int x) { return d.x == 0.0f ? t1 : Crossing(static_cast<float>(d.x > 0.0f ? x + 1 : x), a.x, d.x); };
+  auto nextY = [&](int y) { return d.y == 0.0f ? t1 : Crossing(static_cast<float>(d.y > 0.0f ? y + 1 : y), a.y, d.y); };
+  auto previousX = [&](int x) { return Crossing(static_cast<float>(d.x > 0.0f ? x : x + 1), a.x, d.x); };
+  auto previousY = [&](int y) { return Crossing(static_cast<float>(d.y > 0.0f ? y : y + 1), a.y, d.y); };
+
+  // Start in the cell whose parameter interval holds t0 (rounding may put the entry
+  // point on the wrong side of the boundary it came through)
+  glm::vec2 entry = a + d * t0;
+  int x = std::max(minX, std::min(maxX - 1, static_cast<int>(std::floor(entry.x))));
+  int y = std::max(minY, std::min(maxY - 1, static_cast<int>(std::floor(entry.y))));
+  if (d.x != 0.0f) {
+    while (nextX(x) <= t0 && x + stepX >= minX && x + stepX < maxX) x += stepX;
+    while (previousX(x) > t0 && x - stepX >= minX && x - stepX < maxX) x -= stepX;
+  }
+  if (d.y != 0.0f) {
+    while (nextY(y) <= t0 && y + stepY >= minY && y + stepY < maxY) y += stepY;
+    while (previousY(y) > t0 && y - stepY >= minY && y - stepY < maxY) y -= stepY;
+  }
+
+  // Amanatides-Woo traversal: always cross the nearer boundary next
+  float t = t0;
+  for (;;) {
+    float crossX = nextX(x);
+    float crossY = nextY(y);
+    float next = std::min(std::min(crossX, crossY), t1);
+    if (next > t) deposit(x, y, (next - t) * length);
+    if (next >= t1) break;
+
+    t = next;
+    if (crossX <= crossY) {
+      x += stepX;
+    }
+    else {
+      y += stepY;
+    }
+    if (x < minX || x >= maxX || y < minY || y >= maxY) break;
+  }
+}
+
+void LightFieldGrid::AccumulateLinePathLength(glm::vec2 a, glm::vec2 b, float intensity,
+  int minX, int minY, int maxX, int maxY) {
+  WalkPathLength(a, b, minX, minY, maxX, maxY, [&](int x, int y, float length) {
+    float& cell = TouchCell(AcquireTile(TileIndex(x, y)), LocalIndex(x, y));
+    cell = std::min(cell + length * intensity, maxBrightness);
+  });
+}
+
 void LightFieldGrid::AccumulateRaySegment(glm::vec2 start, glm::vec2 end, float intensity) {
+  if (pathLengthWeighting) {
+    AccumulateLinePathLength(WorldToGridPoint(start), WorldToGridPoint(end), intensity,
+      0, 0, resolution, resolution);
+    return;
+  }
+
   // Convert world coordinates to grid coordinates
   glm::ivec2 gridStart = WorldToGrid(start);
   glm::ivec2 gridEnd = WorldToGrid(end);
 
   // Use Bresenham's algorithm to accumulate along the line
-  AccumulateLineBresenham(gridStart.x, gridStart.y, gridEnd.x, gridEnd.y, intensity);
+  AccumulateLineClipped(gridStart.x, gridStart.y, gridEnd.x, gridEnd.y, intensity,
+    0, 0, resolution, resolution);
 }
 
-void LightFieldGrid::Update(float deltaTime) {
-  // Apply decay to all cells (creates trail effect)
-  for (int y = 0; y < GRID_SIZE; y++) {
-    for (int x = 0; x < GRID_SIZE; x++) {
-      grid[y][x] *= decayRate;
+void LightFieldGrid::SetShardCount(int count) {
+  shardCount = std::max(count, 0);
+  shards.assign(shardStride * shardCount, 0u);
+  shards.shrink_to_fit();
+}
 
-      // Clean up very small values
-      if (grid[y][x] < 0.001f) {
-        grid[y][x] = 0.0f;
+void LightFieldGrid::AccumulateLineBresenham(uint32_t* shard, int x0, int y0, int x1, int y1, uint32_t weight) {
+  // Same walk as above; the brightness clamp waits for MergeShards
+  int dx = abs(x1 - x0);
+  int dy = abs(y1 - y0);
+  int sx = (x0 < x1) ? 1 : -1;
+  int sy = (y0 < y1) ? 1 : -1;
+  int err = dx - dy;
+
+  while (true) {
+    if (x0 >= 0 && x0 < resolution && y0 >= 0 && y0 < resolution) {
+      shard[TileIndex(x0, y0) * TILE_CELLS + LocalIndex(x0, y0)] += weight;
+    }
+
+    if (x0 == x1 && y0 == y1) break;
+
+    int e2 = 2 * err;
+    if (e2 > -dy) {
+      err -= dy;
+      x0 += sx;
+    }
+    if (e2 < dx) {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+void LightFieldGrid::AccumulateRaySegment(int shard, glm::vec2 start, glm::vec2 end, float intensity) {
+  if (pathLengthWeighting) {
+    uint32_t* cells = shards.data() + shard * shardStride;
+    WalkPathLength(WorldToGridPoint(start), WorldToGridPoint(end), 0, 0, resolution, resolution,
+      [&](int x, int y, float length) {
+        cells[TileIndex(x, y) * TILE_CELLS + LocalIndex(x, y)] +=
+          static_cast<uint32_t>(std::lround(std::max(length * intensity, 0.0f) * SHARD_SCALE));
+      });
+    return;
+  }
+
+  glm::ivec2 gridStart = WorldToGrid(start);
+  glm::ivec2 gridEnd = WorldToGrid(end);
+  uint32_t weight = static_cast<uint32_t>(std::lround(std::max(intensity, 0.0f) * SHARD_SCALE));
+  AccumulateLineBresenham(shards.data() + shard * shardStride,
+    gridStart.x, gridStart.y, gridEnd.x, gridEnd.y, weight);
+}
+
+void LightFieldGrid::MergeShards(size_t tileBegin, size_t tileEnd) {
+  uint32_t* base = shards.data();
+  const float scale = 1.0f / SHARD_SCALE;
+
+  for (size_t t = tileBegin; t < tileEnd; t++) {
+    size_t cellBegin = t * TILE_CELLS;
+    size_t cellEnd = cellBegin + TILE_CELLS;
+
+    // Pairwise tree reduction into shard 0; each level is a straight vectorizable add,
+    // and a shard is cleared as soon as it has been folded in
+    for (int stride = 1; stride < shardCount; stride *= 2) {
+      for (int s = 0; s + stride < shardCount; s += 2 * stride) {
+        uint32_t* dst = base + s * shardStride;
+        uint32_t* src = base + (s + stride) * shardStride;
+        for (size_t c = cellBegin; c < cellEnd; ++c) {
+          dst[c] += src[c];
+          src[c] = 0;
+        }
+      }
+    }
+
+    // Nothing drawn here: a sparse tile stays unallocated
+    uint32_t* weights = base + cellBegin;
+    if (!tiles[t] && std::all_of(weights, weights + TILE_CELLS, [](uint32_t w) { return w == 0; })) {
+      continue;
+    }
+    TileBlock& block = AcquireTile(t);
+
+    // Apply the summed weights with a single clamp per cell
+    if (lazyDecay) {
+      // Only cells that received weight are brought up to date
+      for (int i = 0; i < TILE_CELLS; i++) {
+        if (weights[i] == 0) continue;
+        float& cell = TouchCell(block, i);
+        cell = std::min(cell + static_cast<float>(weights[i]) * scale, maxBrightness);
+        weights[i] = 0;
       }
+      continue;
+    }
+
+    for (int i = 0; i < TILE_CELLS; i++) {
+      block.cells[i] = std::min(block.cells[i] + static_cast<float>(weights[i]) * scale, maxBrightness);
+      weights[i] = 0;
     }
   }
+}
 
-  // Update vertex colors based on grid intensity
-  UpdateVertices();
+void LightFieldGrid::BeginBinning(size_t binCount) {
+  // Keep the lists (and their capacity) from earlier steps
+  if (bins.size() < binCount) bins.resize(binCount);
+  for (std::vector<BinnedSegment>& bin : bins) {
+    bin.clear();
+  }
 }
 
-glm::vec3 LightFieldGrid::IntensityToColor(float intensity) const {
-  // Apply threshold - return black for intensities below threshold
-  if (intensity < displayThreshold) {
-    return glm::vec3(0.0f, 0.0f, 0.0f);
+void LightFieldGrid::BinRaySegment(size_t bin, glm::vec2 start, glm::vec2 end, float intensity) {
+  glm::vec2 pointStart = WorldToGridPoint(start);
+  glm::vec2 pointEnd = WorldToGridPoint(end);
+  glm::ivec2 gridStart = WorldToGrid(start);
+  glm::ivec2 gridEnd = WorldToGrid(end);
+
+  // Every cell either walk visits lies inside the bounding box of the endpoint cells,
+  // so its tiles cover the segment
+  int tileX0 = std::min(gridStart.x, gridEnd.x) / TILE_SIZE;
+  int tileX1 = std::max(gridStart.x, gridEnd.x) / TILE_SIZE;
+  int tileY0 = std::min(gridStart.y, gridEnd.y) / TILE_SIZE;
+  int tileY1 = std::max(gridStart.y, gridEnd.y) / TILE_SIZE;
+
+  std::vector<BinnedSegment>& list = bins[bin];
+  for (int ty = tileY0; ty <= tileY1; ty++) {
+    for (int tx = tileX0; tx <= tileX1; tx++) {
+      list.push_back({ pointStart.x, pointStart.y, pointEnd.x, pointEnd.y, intensity,
+        static_cast<uint32_t>(ty * tilesPerSide + tx) });
+    }
+  }
+}
+
+void LightFieldGrid::SortBins() {
+  // Counting sort by tile; stable, so each tile keeps bin order then insertion order
+  tileOffsets.assign(GetTileCount() + 1, 0u);
+  for (const std::vector<BinnedSegment>& bin : bins) {
+    for (const BinnedSegment& segment : bin) {
+      tileOffsets[segment.tile + 1]++;
+    }
+  }
+  for (size_t t = 0; t < GetTileCount(); t++) {
+    tileOffsets[t + 1] += tileOffsets[t];
+  }
+
+  tileSegments.resize(tileOffsets.back());
+  tileCursor.assign(tileOffsets.begin(), tileOffsets.end() - 1);
+  for (const std::vector<BinnedSegment>& bin : bins) {
+    for (const BinnedSegment& segment : bin) {
+      tileSegments[tileCursor[segment.tile]++] = segment;
+    }
   }
+}
 
-  // Map intensity to color gradient
-  // Remap intensity from (threshold, maxBrightness) to (0, 1)
-  float normalized = (intensity - displayThreshold) / (maxBrightness - displayThreshold);
-  normalized = std::max(0.0f, std::min(1.0f, normalized));
+void LightFieldGrid::GetTileBounds(size_t tile, int& minX, int& minY, int& maxX, int& maxY) const {
+  minX = static_cast<int>(tile % tilesPerSide) * TILE_SIZE;
+  minY = static_cast<int>(tile / tilesPerSide) * TILE_SIZE;
+  maxX = std::min(minX + TILE_SIZE, resolution);
+  maxY = std::min(minY + TILE_SIZE, resolution);
+}
 
-  glm::vec3 color;
+void LightFieldGrid::RasterizeTiles(size_t tileBegin, size_t tileEnd) {
+  for (size_t t = tileBegin; t < tileEnd; t++) {
+    int minX, minY, maxX, maxY;
+    GetTileBounds(t, minX, minY, maxX, maxY);
+
+    for (uint32_t k = tileOffsets[t]; k < tileOffsets[t + 1]; k++) {
+      const BinnedSegment& segment = tileSegments[k];
+      if (pathLengthWeighting) {
+        AccumulateLinePathLength(glm::vec2(segment.x0, segment.y0), glm::vec2(segment.x1, segment.y1),
+          segment.intensity, minX, minY, maxX, maxY);
+        continue;
+      }
 
-  if (normalized < 0.25f) {
-    // Black to dark blue
-    float t = normalized * 4.0f;
-    color = glm::vec3(0.0f, 0.0f, t * 0.3f);
+      // Endpoint cells, as WorldToGrid would give them
+      int x0 = std::max(0, std::min(resolution - 1, static_cast<int>(segment.x0)));
+      int y0 = std::max(0, std::min(resolution - 1, static_cast<int>(segment.y0)));
+      int x1 = std::max(0, std::min(resolution - 1, static_cast<int>(segment.x1)));
+      int y1 = std::max(0, std::min(resolution - 1, static_cast<int>(segment.y1)));
+      AccumulateLineClipped(x0, y0, x1, y1, segment.intensity, minX, minY, maxX, maxY);
+    }
   }
-  else if (normalized < 0.5f) {
-    // Dark blue to blue
-    float t = (normalized - 0.25f) * 4.0f;
-    color = glm::vec3(0.0f, t * 0.2f, 0.3f + t * 0.4f);
+}
+
+void LightFieldGrid::Decay(size_t tileBegin, size_t tileEnd) {
+  if (lazyDecay) return;
+  ResolveTiles(tileBegin, tileEnd, true, 0.0f, nullptr);
+  for (size_t t = tileBegin; t < tileEnd; t++) ReleaseIfFaded(t);
+}
+
+void LightFieldGrid::Resolve(float alpha, std::vector<float>& displayData) {
+  Resolve(alpha, displayData, 0, GetTileCount());
+}
+
+void LightFieldGrid::Resolve(float alpha, std::vector<float>& displayData, size_t tileBegin, size_t tileEnd) {
+  if (lazyDecay) {
+    ResolveLazy(alpha, displayData.data(), tileBegin, tileEnd);
+    return;
   }
-  else if (normalized < 0.75f) {
-    // Blue to cyan
-    float t = (normalized - 0.5f) * 4.0f;
-    color = glm::vec3(t * 0.3f, 0.2f + t * 0.5f, 0.7f + t * 0.3f);
+  ResolveTiles(tileBegin, tileEnd, false, alpha, displayData.data());
+}
+
+void LightFieldGrid::DecayAndResolve(float alpha, std::vector<float>& displayData, size_t tileBegin, size_t tileEnd) {
+  if (lazyDecay) {
+    ResolveLazy(alpha, displayData.data(), tileBegin, tileEnd);
+    return;
   }
-  else {
-    // Cyan to white
-    float t = (normalized - 0.75f) * 4.0f;
-    color = glm::vec3(0.3f + t * 0.7f, 0.7f + t * 0.3f, 1.0f);
+  ResolveTiles(tileBegin, tileEnd, true, alpha, displayData.data());
+  for (size_t t = tileBegin; t < tileEnd; t++) ReleaseIfFaded(t);
+}
+
+LightFieldResolveParams LightFieldGrid::ResolveParams(float alpha) const {
+  LightFieldResolveParams params;
+  params.decayRate = decayRate;
+  params.flushBelow = FLUSH_BELOW;
+  params.alpha = alpha;
+  params.displayThreshold = displayThreshold;
+  return params;
+}
+
+uint32_t LightFieldGrid::BeginDisplayFrame() {
+  displayFrame++;
+
+  // What counts as black has moved, so every tile's texels may draw differently, and
+  // faded tiles must be resolved again to find out
+  if (displayThreshold != trackedThreshold) {
+    trackedThreshold = displayThreshold;
+    std::fill(tileChangeFrames.begin(), tileChangeFrames.end(), displayFrame);
+    std::fill(tileFadedStep.begin(), tileFadedStep.end(), NOT_FADED);
   }
+  return displayFrame;
+}
 
-  return color;
+void LightFieldGrid::TrackTileDisplay(size_t tile, bool visible) {
+  if (visible || tileVisible[tile]) tileChangeFrames[tile] = displayFrame;
+  tileVisible[tile] = visible;
 }
 
-void LightFieldGrid::UpdateVertices() {
-  // Update color values in vertex buffer based on grid intensities
-  for (int y = 0; y < GRID_SIZE; y++) {
-    for (int x = 0; x < GRID_SIZE; x++) {
-      float intensity = grid[y][x];
-      glm::vec3 color = IntensityToColor(intensity);
+void LightFieldGrid::ResolveTiles(size_t tileBegin, size_t tileEnd, bool decay, float alpha, float* display) {
+  LightFieldResolveParams params = ResolveParams(alpha);
 
-      // Calculate base index for this cell's vertices
-      int cellIndex = y * GRID_SIZE + x;
-      int baseVertexIndex = cellIndex * 4 * 5; // 4 vertices * 5 floats each
+  for (size_t t = tileBegin; t < tileEnd; t++) {
+    TileBlock* block = tiles[t].get();
+    if (!block) {
+      if (display) TrackTileDisplay(t, false);
+      continue;
+    }
 
-      // Update colors for all 4 vertices of this cell
-      for (int v = 0; v < 4; v++) {
-        int colorIndex = baseVertexIndex + v * 5 + 2; // +2 to skip x,y
-        vertices[colorIndex] = color.r;
-        vertices[colorIndex + 1] = color.g;
-        vertices[colorIndex + 2] = color.b;
-      }
+    // Decay only: the whole block in one run
+    if (!display) {
+      LightFieldResolveRow all = { block->cells, nullptr, block->cells, nullptr };
+      resolveKernel(all, TILE_CELLS, params);
+      continue;
     }
-  }
 
-  // Update VBO with new colors
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+    int minX, minY, maxX, maxY;
+    GetTileBounds(t, minX, minY, maxX, maxY);
+    bool visible = false;
+
+    for (int y = minY; y < maxY; y++) {
+      size_t cell = (y - minY) * TILE_SIZE;
+
+      LightFieldResolveRow row;
+      row.current = block->cells + cell;
+      row.previous = block->previous + cell;
+      row.decayed = decay ? block->cells + cell : nullptr;
+      row.display = display + static_cast<size_t>(y) * resolution + minX;
+      visible |= resolveKernel(row, maxX - minX, params);
+    }
+    TrackTileDisplay(t, visible);
+  }
 }
 
-void LightFieldGrid::Render(unsigned int shaderProgram) {
-  glUseProgram(shaderProgram);
+void LightFieldGrid::ResolveLazy(float alpha, float* display, size_t tileBegin, size_t tileEnd) {
+  LightFieldResolveParams params = ResolveParams(alpha);
+  float current[TILE_SIZE];
+  float previous[TILE_SIZE];
+
+  for (size_t t = tileBegin; t < tileEnd; t++) {
+    // A faded tile that has not been written since can only have faded further: it stays
+    // black, and black tiles have no display data to refresh
+    TileBlock* block = tiles[t].get();
+    if (!block) {
+      TrackTileDisplay(t, false);
+      continue;
+    }
+    if (tileFadedStep[t] != NOT_FADED && block->writtenStep <= tileFadedStep[t]) continue;
+
+    int minX, minY, maxX, maxY;
+    GetTileBounds(t, minX, minY, maxX, maxY);
+    float brightest = 0.0f;
+    bool visible = false;
+
+    for (int y = minY; y < maxY; y++) {
+      size_t cell = (y - minY) * TILE_SIZE;
+      int count = maxX - minX;
+
+      // Decay each cell to now; cells written this step saved their previous value
+      for (int x = 0; x < count; x++) {
+        uint32_t last = block->lastStep[cell + x];
+        float value = block->cells[cell + x];
+        current[x] = DecayedBy(value, step + 1 - last);
+        previous[x] = last >= step ? block->previous[cell + x] : DecayedBy(value, step - last);
+        brightest = std::max(brightest, std::max(current[x], previous[x]));
+      }
 
-  // Set uniform for grid rendering mode
-  glUniform4f(glGetUniformLocation(shaderProgram, "u_Color"), 1.0f, 1.0f, 1.0f, 1.0f);
+      LightFieldResolveRow row = { current, previous, nullptr,
+        display + static_cast<size_t>(y) * resolution + minX };
+      visible |= resolveKernel(row, count, params);
+    }
+    TrackTileDisplay(t, visible);
 
-  glBindVertexArray(VAO);
-  glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-  glBindVertexArray(0);
-}
\ No newline at end of file
+    // Everything has faded out of sight
+    tileFadedStep[t] = brightest < displayThreshold ? step : NOT_FADED;
+    if (sparse && brightest < displayThreshold) {
+      std::lock_guard<std::mutex> lock(freeBlocksMutex);
+      freeBlocks.push_back(std::move(tiles[t]));
+    }
+  }
+}
@@ -1,17 +1,31 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
+#include "AlignedAllocator.h"
+#include "LightFieldKernel.h"
 
+// Simulation half of the light field: cell state, accumulation, decay and resolve.
+// It makes no GL calls; LightFieldView draws what it resolves. Once the simulation
+// thread is running, that thread (and the tasks it runs) owns the grid.
 class LightFieldGrid {
 public:
-  static const int GRID_SIZE = 100;  // 100x100 grid
+  static const int DEFAULT_RESOLUTION = 256;  // 256x256 grid
 
-  LightFieldGrid();
-  ~LightFieldGrid();
+  // Cells per side, chosen at runtime (e.g. 256 to 16384).
+  // Cell state lives in TILE_SIZE² blocks. A dense grid allocates them all up front;
+  // a sparse one allocates a tile when something is first drawn into it and frees it
+  // again once every cell has faded below the display threshold, so memory and
+  // decay work follow the lit area.
+  explicit LightFieldGrid(int resolution = DEFAULT_RESOLUTION, bool sparse = false);
 
-  // Initialize OpenGL resources for rendering
-  bool Initialize();
+  int GetResolution() const { return resolution; }
+  bool IsSparse() const { return sparse; }
+  size_t GetAllocatedTileCount() const;
 
   // Clear the grid
   void Clear();
@@ -19,17 +33,91 @@ public:
   // Add ray contribution to grid cells along a line segment
   void AccumulateRaySegment(glm::vec2 start, glm::vec2 end, float intensity = 1.0f);
 
-  // Update the grid (apply decay, etc.)
-  void Update(float deltaTime);
-
-  // Render the grid as colored quads
-  void Render(unsigned int shaderProgram);
+  // How a segment is deposited. By default every cell the Bresenham line touches gets the
+  // full intensity. With path-length weighting, a cell gets intensity times the length of
+  // segment inside it (in cell widths), found by an Amanatides-Woo grid walk from the
+  // exact endpoints: energy per unit length no longer depends on direction, and sub-cell
+  // positions are kept. Applies to every accumulation path below.
+  void SetPathLengthWeighting(bool enabled) { pathLengthWeighting = enabled; }
+  bool IsPathLengthWeighting() const { return pathLengthWeighting; }
+
+  // Private shards for parallel accumulation: each thread adds segments to its own shard
+  // and MergeShards folds them into the grid. Shards hold fixed-point weights, so the
+  // merged result does not depend on which thread drew which segment.
+  // Shards always cover the whole grid; a count of 0 frees them.
+  void SetShardCount(int count);
+  int GetShardCount() const { return shardCount; }
+  void AccumulateRaySegment(int shard, glm::vec2 start, glm::vec2 end, float intensity = 1.0f);
+
+  // Add the shards into tiles [tileBegin, tileEnd) of the grid, clamp once and clear them.
+  // Different tiles may be merged on different threads.
+  void MergeShards(size_t tileBegin, size_t tileEnd);
+
+  // Binned (sort-middle) accumulation, which needs no extra grid copies:
+  //   BeginBinning(binCount) empties binCount segment lists;
+  //   BinRaySegment files a segment under every TILE_SIZE² tile its bounding box touches
+  //     (one bin per thread or chunk; different bins may be filled in parallel);
+  //   SortBins groups the segments by tile, keeping bin order then insertion order;
+  //   RasterizeTiles draws tiles [tileBegin, tileEnd), each owned by one caller.
+  // Cells receive their segments in the same order as calling AccumulateRaySegment
+  // bin by bin, so the result matches the serial path exactly.
+  void BeginBinning(size_t binCount);
+  void BinRaySegment(size_t bin, glm::vec2 start, glm::vec2 end, float intensity = 1.0f);
+  void SortBins();
+  void RasterizeTiles(size_t tileBegin, size_t tileEnd);
+
+  // The grid is split into TILE_SIZE² tiles (row-major); the per-tile operations below
+  // touch only their own cells, so different tiles can be processed concurrently
+  static const int TILE_SIZE = 32;
+  size_t GetTileCount() const { return static_cast<size_t>(tilesPerSide) * tilesPerSide; }
+  void GetTileBounds(size_t tile, int& minX, int& minY, int& maxX, int& maxY) const;
+
+  // Lazy decay: instead of decaying every cell each step, a cell keeps the value it had
+  // when last written and the step it was written in, and decayRate^(steps since) is
+  // applied when it is next accumulated into or resolved for display. Steps then only touch cells
+  // that rays cross, and Decay becomes a no-op. Switching converts the whole grid once.
+  void SetLazyDecay(bool enabled);
+  bool IsLazyDecay() const { return lazyDecay; }
+
+  // Snapshot the grid before a simulation step adds to it (the interpolation start point).
+  // With lazy decay only the step counter advances; cells save their old value on first touch.
+  void BeginStep();
+
+  // Decay of tiles [tileBegin, tileEnd) only
+  void Decay(size_t tileBegin, size_t tileEnd);
+
+  // Write the intensities to draw, blended between the last two steps by alpha, into an
+  // array of GetDisplayDataSize() floats (one per cell, row-major, unpadded).
+  void Resolve(float alpha, std::vector<float>& displayData);
+  void Resolve(float alpha, std::vector<float>& displayData, size_t tileBegin, size_t tileEnd);
+  size_t GetDisplayDataSize() const { return static_cast<size_t>(resolution) * resolution; }
+
+  // Decay and Resolve of tiles [tileBegin, tileEnd) fused into one sweep over the cells
+  void DecayAndResolve(float alpha, std::vector<float>& displayData, size_t tileBegin, size_t tileEnd);
+
+  // Display change tracking, so the texture upload can skip what has not changed.
+  // BeginDisplayFrame numbers the next display frame (call it before that frame's Resolve
+  // or DecayAndResolve calls); resolving a tile then records the frame in which its picture
+  // last changed. A tile that resolves entirely below the display threshold, and did the
+  // time before too, draws black either way and keeps its old record. Changing the
+  // threshold marks every tile changed.
+  // Only visible tiles need their display data: the cells of a tile that draws black may be
+  // left as they were, and are to be drawn as zero (see GetTileVisible). With lazy decay, a
+  // tile that had faded below the threshold and has not been written since is skipped
+  // entirely, so idle dark regions cost nothing.
+  uint32_t BeginDisplayFrame();
+  uint32_t GetDisplayFrame() const { return displayFrame; }
+  const std::vector<uint32_t>& GetTileChangeFrames() const { return tileChangeFrames; }
+  const std::vector<uint8_t>& GetTileVisible() const { return tileVisible; }
 
   // Convert world coordinates to grid coordinates
   glm::ivec2 WorldToGrid(glm::vec2 worldPos) const;
 
+  // Width of the square of world space the grid covers, centred on the origin
+  float GetWorldSize() const { return worldSize; }
+
   // Get/Set decay rate
-  void SetDecayRate(float rate) { decayRate = rate; }
+  void SetDecayRate(float rate);
   float GetDecayRate() const { return decayRate; }
 
   // Get/Set max brightness
@@ -41,13 +129,53 @@ public:
   float GetDisplayThreshold() const { return displayThreshold; }
 
 private:
-  // Grid data - stores accumulated light intensity
-  std::vector<std::vector<float>> grid;
-
-  // Rendering
-  unsigned int VAO, VBO, EBO;
-  std::vector<float> vertices;
-  std::vector<unsigned int> indices;
+  int resolution;         // Cells per side
+  bool sparse;            // Tiles are allocated on demand and freed once faded
+
+  // Cell state of one tile, row-major within the tile. Cells past the edge of the grid
+  // (in the last row and column of tiles) stay zero.
+  static const int TILE_CELLS = TILE_SIZE * TILE_SIZE;
+  struct alignas(64) TileBlock {
+    float cells[TILE_CELLS];        // Accumulated light intensity
+    float previous[TILE_CELLS];     // Intensity at the start of the last step
+    uint32_t lastStep[TILE_CELLS];  // Step of the last write (lazy decay)
+    uint32_t writtenStep;           // Latest lastStep of any cell (lazy decay)
+  };
+  std::vector<std::unique_ptr<TileBlock>> tiles;      // Per tile; null while unallocated
+  std::vector<std::unique_ptr<TileBlock>> freeBlocks; // Released blocks, kept for reuse
+  std::mutex freeBlocksMutex;                          // Tiles are allocated from tile tasks
+
+  static constexpr float FLUSH_BELOW = 0.001f;    // Decayed cells below this are cleared to zero
+
+  // Accumulation shards: shardCount blocks of shardStride cells, laid out tile by tile
+  static constexpr float SHARD_SCALE = 65536.0f;  // Fixed-point units per unit of intensity
+  AlignedVector<uint32_t> shards;
+  size_t shardStride;     // Cells per shard
+  int shardCount;
+
+  bool pathLengthWeighting;
+
+  // Segment bins: a segment in continuous grid coordinates, filed under one tile
+  struct BinnedSegment {
+    float x0, y0, x1, y1;
+    float intensity;
+    uint32_t tile;
+  };
+  int tilesPerSide;
+  std::vector<std::vector<BinnedSegment>> bins;
+  std::vector<BinnedSegment> tileSegments;  // All bins, grouped by tile
+  std::vector<uint32_t> tileOffsets;        // Start of each tile's run (GetTileCount() + 1 entries)
+  std::vector<uint32_t> tileCursor;         // Scratch for SortBins
+
+  // Display change tracking (see BeginDisplayFrame)
+  uint32_t displayFrame;                  // Display frames begun so far
+  float trackedThreshold;                 // Threshold tileVisible was found with
+  std::vector<uint8_t> tileVisible;       // Tile drew more than black at its last resolve
+  std::vector<uint32_t> tileChangeFrames; // Display frame of each tile's last change
+  // Step in which a lazy resolve last found a tile faded (every cell below the display
+  // threshold at any blend), or NOT_FADED
+  static constexpr uint32_t NOT_FADED = UINT32_MAX;
+  std::vector<uint32_t> tileFadedStep;
 
   // Parameters
   float decayRate;        // How fast cells fade (0.98 = slow fade)
@@ -55,8 +183,45 @@ private:
   float displayThreshold; // Minimum intensity to display
   float worldSize;        // Size of world space (-2 to 2)
 
+  // Lazy decay state: a cell written in step lastStep[i] holds cells[i] before that step's
+  // decay, so its value now is cells[i] * decayPowers[step - lastStep[i] + 1]
+  bool lazyDecay;
+  uint32_t step;                      // Steps begun so far
+  std::vector<float> decayPowers;     // decayRate^k; the last entry applies to all larger k
+
+  // Vectorized decay/blend kernel for this CPU
+  LightFieldResolveFn resolveKernel;
+
   // Helper methods
-  void UpdateVertices();
-  glm::vec3 IntensityToColor(float intensity) const;
-  void AccumulateLineBresenham(int x0, int y0, int x1, int y1, float intensity);
+  // Block of a tile, allocating it on first use (callers must own the tile)
+  TileBlock& AcquireTile(size_t tile);
+  // Return a sparse tile to the free list once all its cells are below the display threshold
+  void ReleaseIfFaded(size_t tile);
+  static size_t LocalIndex(int x, int y) { return (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE; }
+  size_t TileIndex(int x, int y) const { return (y / TILE_SIZE) * tilesPerSide + x / TILE_SIZE; }
+  void BuildDecayPowers();
+  float DecayedBy(float value, uint32_t steps) const;
+  // Bring a lazily decayed cell up to date before the first write of this step
+  float& TouchCell(TileBlock& block, size_t cell);
+  // Resolve tiles from the lazy representation (current and previous values per row),
+  // releasing sparse tiles that have faded
+  void ResolveLazy(float alpha, float* display, size_t tileBegin, size_t tileEnd);
+  LightFieldResolveParams ResolveParams(float alpha) const;
+  // Run the resolve kernel over tiles; decay and/or blend (null display: decay only)
+  void ResolveTiles(size_t tileBegin, size_t tileEnd, bool decay, float alpha, float* display);
+  // Record whether a freshly resolved tile draws anything, and if its picture changed
+  void TrackTileDisplay(size_t tile, bool visible);
+  // World position to continuous grid coordinates (cell (x, y) spans [x, x + 1) x [y, y + 1))
+  glm::vec2 WorldToGridPoint(glm::vec2 worldPos) const;
+  // Bresenham walk, writing only cells inside [minX, maxX) x [minY, maxY)
+  void AccumulateLineClipped(int x0, int y0, int x1, int y1, float intensity,
+    int minX, int minY, int maxX, int maxY);
+  // Path-length weighted walk from a to b (grid coordinates), clipped the same way
+  void AccumulateLinePathLength(glm::vec2 a, glm::vec2 b, float intensity,
+    int minX, int minY, int maxX, int maxY);
+  // Calls deposit(x, y, length) for each cell the segment a-b crosses inside the clip box
+  template <typename Deposit>
+  static void WalkPathLength(glm::vec2 a, glm::vec2 b, int minX, int minY, int maxX, int maxY,
+    Deposit deposit);
+  void AccumulateLineBresenham(uint32_t* shard, int x0, int y0, int x1, int y1, uint32_t weight);
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "LightFieldKernel.h"
+#include "LightFieldKernelSimd.h"
+
+template <bool Decay, bool Display>
+static bool ResolveScalar(const LightFieldResolveRow& row, size_t count, const LightFieldResolveParams& params) {
+  bool visible = false;
+  for (size_t i = 0; i < count; ++i) {
+    float value = row.current[i];
+    if (Decay) {
+      value *= params.decayRate;
+      if (value < params.flushBelow) value = 0.0f;
+      row.decayed[i] = value;
+    }
+
+    // Blend from the previous step so motion is smooth between fixed steps
+    if (Display) {
+      float blended = row.previous[i] + (value - row.previous[i]) * params.alpha;
+      row.display[i] = blended;
+      visible |= blended >= params.displayThreshold;
+    }
+  }
+  return visible;
+}
+
+bool LightFieldResolveScalar(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params) {
+  if (row.decayed && row.display) return ResolveScalar<true, true>(row, count, params);
+  if (row.decayed) return ResolveScalar<true, false>(row, count, params);
+  if (row.display) return ResolveScalar<false, true>(row, count, params);
+  return false;
+}
+
+LightFieldResolveFn GetLightFieldResolveKernel(SimdLevel level) {
+  switch (ClampSimdLevel(level)) {
+#if defined(OPENGLFW_SIMD_X86)
+  case SimdLevel::SSE41: return LightFieldResolveSSE41;
+  case SimdLevel::AVX2: return LightFieldResolveAVX2;
+  case SimdLevel::AVX512: return LightFieldResolveAVX512;
+#endif
+#if defined(OPENGLFW_SIMD_NEON)
+  case SimdLevel::NEON: return LightFieldResolveNEON;
+#endif
+  default: return LightFieldResolveScalar;
+  }
+}
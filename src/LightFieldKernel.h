@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include "GeodesicKernel.h"
+
+// Uniform parameters for one light field resolve sweep
+struct LightFieldResolveParams {
+  float decayRate;         // Per-step multiplier
+  float flushBelow;        // Decayed cells below this become exactly zero
+  float alpha;             // Blend from the previous step (0) to the current one (1)
+  float displayThreshold;  // Blended intensities from here up are drawn (see return value)
+};
+
+// One run of cells processed by the kernel
+struct LightFieldResolveRow {
+  const float* current;    // Intensities after accumulation
+  const float* previous;   // Intensities at the start of the step (display blend origin)
+  float* decayed;          // Receives the decayed intensities (may alias current); null: no decay
+  float* display;          // Receives the blended intensities to draw; null: no display output
+};
+
+// Decays, flushes and blends cells [0, count) of a row in one sweep. The colour mapping
+// of the blended intensities happens on the GPU. Returns whether any blended intensity
+// reached params.displayThreshold (false when there is no display output), i.e. whether
+// the row draws anything but black.
+using LightFieldResolveFn = bool (*)(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params);
+
+// Scalar reference implementation (same operation order as the vector kernels)
+bool LightFieldResolveScalar(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params);
+
+// Kernel for a level; unsupported levels fall back to the scalar kernel
+LightFieldResolveFn GetLightFieldResolveKernel(SimdLevel level);
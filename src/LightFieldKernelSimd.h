@@ -0,0 +1,73 @@
+#pragma once
+
+// Width-generic light field resolve kernel.
+// Instantiated by the same per-ISA translation units as GeodesicStepSimd, with
+// their vector types (see GeodesicKernelSimd.h for what V provides).
+
+#include "LightFieldKernel.h"
+
+#if defined(OPENGLFW_SIMD_X86)
+bool LightFieldResolveSSE41(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params);
+bool LightFieldResolveAVX2(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params);
+bool LightFieldResolveAVX512(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params);
+#endif
+
+#if defined(OPENGLFW_SIMD_NEON)
+bool LightFieldResolveNEON(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params);
+#endif
+
+// Vector part of the sweep; returns the cells done, and sets visible if any blended
+// intensity reached the display threshold
+template <typename V, bool Decay, bool Display>
+size_t LightFieldResolveLanes(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params, bool& visible) {
+  using F = typename V::F;
+
+  const F zero = V::Set(0.0f);
+  const F decayRate = V::Set(params.decayRate);
+  const F flushBelow = V::Set(params.flushBelow);
+  const F alpha = V::Set(params.alpha);
+  F brightest = zero;
+
+  size_t i = 0;
+  for (; i + V::Width <= count; i += V::Width) {
+    F value = V::Load(row.current + i);
+    if (Decay) {
+      value = value * decayRate;
+      value = V::Select(value < flushBelow, zero, value);
+      V::Store(row.decayed + i, value);
+    }
+    if (Display) {
+      F previous = V::Load(row.previous + i);
+      F blended = previous + (value - previous) * alpha;
+      V::Store(row.display + i, blended);
+      brightest = V::Max(brightest, blended);
+    }
+  }
+  if (Display) visible = V::Bits(V::Set(params.displayThreshold) <= brightest) != 0;
+  return i;
+}
+
+template <typename V>
+bool LightFieldResolveSimd(const LightFieldResolveRow& row, size_t count,
+  const LightFieldResolveParams& params) {
+  size_t done = 0;
+  bool visible = false;
+  if (row.decayed && row.display) done = LightFieldResolveLanes<V, true, true>(row, count, params, visible);
+  else if (row.decayed) done = LightFieldResolveLanes<V, true, false>(row, count, params, visible);
+  else if (row.display) done = LightFieldResolveLanes<V, false, true>(row, count, params, visible);
+
+  // Leftover cells at the end of the row
+  LightFieldResolveRow tail = {
+    row.current + done,
+    row.previous ? row.previous + done : nullptr,
+    row.decayed ? row.decayed + done : nullptr,
+    row.display ? row.display + done : nullptr
+  };
+  bool tailVisible = LightFieldResolveScalar(tail, count - done, params);
+  return visible || tailVisible;
+}
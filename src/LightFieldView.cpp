@@ -0,0 +1,186 @@
+#include "LightFieldView.h"
+#include "LightFieldGrid.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+// Change frames come per grid tile
+static const int TILE_SIZE = LightFieldGrid::TILE_SIZE;
+
+LightFieldView::LightFieldView(int cells, float size)
+  : resolution(std::max(cells, 1))
+  , tilesPerSide((resolution + TILE_SIZE - 1) / TILE_SIZE)
+  , worldSize(size)
+  , VAO(0)
+  , quadVBO(0)
+  , texture(0)
+  , paletteTexture(0)
+  , drawThreshold(0.05f)
+  , drawMaxBrightness(5.0f)
+  , uploadedFrame(0) {
+}
+
+LightFieldView::~LightFieldView() {
+  if (VAO) glDeleteVertexArrays(1, &VAO);
+  if (quadVBO) glDeleteBuffers(1, &quadVBO);
+  if (texture) glDeleteTextures(1, &texture);
+  if (paletteTexture) glDeleteTextures(1, &paletteTexture);
+}
+
+bool LightFieldView::Initialize() {
+  // The whole grid is one quad; the texture supplies the cells
+  const float quad[] = {
+    0.0f, 0.0f,  // Bottom left
+    1.0f, 0.0f,  // Bottom right
+    1.0f, 1.0f,  // Top right
+    0.0f, 1.0f   // Top left
+  };
+
+  // Create OpenGL objects
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &quadVBO);
+
+  glBindVertexArray(VAO);
+
+  // Position attribute (quad corner, doubling as texture coordinate)
+  glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+  glEnableVertexAttribArray(0);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Intensity texture: one float per cell, row y of the grid is texture row y.
+  // Nearest filtering keeps each cell a flat square, as before.
+  std::vector<float> dark(static_cast<size_t>(resolution) * resolution, 0.0f);
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, resolution, resolution, 0, GL_RED, GL_FLOAT, dark.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  // Staging ring for uploads; a region holds the whole grid, for frames where every tile changed
+  bool staged = uploadStream.Initialize(GL_PIXEL_UNPACK_BUFFER, dark.size() * sizeof(float));
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  if (!staged) return false;
+
+  // Colormap: linear filtering interpolates between neighbouring entries
+  glGenTextures(1, &paletteTexture);
+  glBindTexture(GL_TEXTURE_1D, paletteTexture);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_1D, 0);
+  SetPalette(HEAT_PALETTE.data(), HEAT_PALETTE.size());
+
+  return true;
+}
+
+void LightFieldView::Upload(const std::vector<float>& displayData, const std::vector<uint32_t>& changeFrames,
+  const std::vector<uint8_t>& visibleTiles, uint32_t frame, float threshold, float brightness) {
+  drawThreshold = threshold;
+  drawMaxBrightness = brightness;
+
+  // Each run of changed tiles along a tile row becomes one rectangle
+  uploadRuns.clear();
+  size_t bytes = 0;
+  for (int tileY = 0; tileY < tilesPerSide; tileY++) {
+    const uint32_t* changes = changeFrames.data() + static_cast<size_t>(tileY) * tilesPerSide;
+    int tileX = 0;
+    while (tileX < tilesPerSide) {
+      if (changes[tileX] <= uploadedFrame) {
+        tileX++;
+        continue;
+      }
+      int runBegin = tileX;
+      while (tileX < tilesPerSide && changes[tileX] > uploadedFrame) tileX++;
+
+      UploadRun run;
+      run.x = runBegin * TILE_SIZE;
+      run.y = tileY * TILE_SIZE;
+      run.width = std::min(tileX * TILE_SIZE, resolution) - run.x;
+      run.height = std::min(run.y + TILE_SIZE, resolution) - run.y;
+      run.offset = bytes;
+      uploadRuns.push_back(run);
+      bytes += static_cast<size_t>(run.width) * run.height * sizeof(float);
+    }
+  }
+  if (uploadRuns.empty()) {
+    uploadedFrame = frame;
+    return;
+  }
+
+  // Pack the rectangles straight into the staging region
+  char* staging = static_cast<char*>(uploadStream.Map(bytes));
+  if (!staging) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return;  // Try again with the next frame
+  }
+  for (const UploadRun& run : uploadRuns) {
+    float* packed = reinterpret_cast<float*>(staging + run.offset);
+    const uint8_t* visible = visibleTiles.data() + static_cast<size_t>(run.y / TILE_SIZE) * tilesPerSide;
+    for (int y = 0; y < run.height; y++) {
+      const float* source = displayData.data() + static_cast<size_t>(run.y + y) * resolution + run.x;
+      float* target = packed + static_cast<size_t>(y) * run.width;
+      // Tile by tile: black tiles may not have been resolved, so their cells are not read
+      for (int x = 0; x < run.width; x += TILE_SIZE) {
+        int end = std::min(x + TILE_SIZE, run.width);
+        if (visible[(run.x + x) / TILE_SIZE]) {
+          std::copy(source + x, source + end, target + x);
+        }
+        else {
+          std::fill(target + x, target + end, 0.0f);
+        }
+      }
+    }
+  }
+  size_t regionOffset = uploadStream.Unmap();
+
+  // The texture reads from the bound unpack buffer (pointers are byte offsets into it)
+  glBindTexture(GL_TEXTURE_2D, texture);
+  for (const UploadRun& run : uploadRuns) {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, run.x, run.y, run.width, run.height, GL_RED, GL_FLOAT,
+      reinterpret_cast<const void*>(regionOffset + run.offset));
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  uploadedFrame = frame;
+}
+
+void LightFieldView::Render(unsigned int shaderProgram) {
+  glUseProgram(shaderProgram);
+
+  // Grid placement in world space
+  glUniform2f(glGetUniformLocation(shaderProgram, "u_GridOrigin"), -worldSize / 2.0f, -worldSize / 2.0f);
+  glUniform1f(glGetUniformLocation(shaderProgram, "u_GridExtent"), worldSize);
+
+  // Colour mapping
+  glUniform1f(glGetUniformLocation(shaderProgram, "u_DisplayThreshold"), drawThreshold);
+  glUniform1f(glGetUniformLocation(shaderProgram, "u_MaxBrightness"), drawMaxBrightness);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glUniform1i(glGetUniformLocation(shaderProgram, "u_Intensity"), 0);
+
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_1D, paletteTexture);
+  glUniform1i(glGetUniformLocation(shaderProgram, "u_Palette"), 1);
+
+  glBindVertexArray(VAO);
+  glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+  glBindVertexArray(0);
+  glBindTexture(GL_TEXTURE_1D, 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void LightFieldView::SetPalette(const PaletteColor* colors, size_t count) {
+  if (count < 2 || count > MAX_PALETTE_SIZE) return;
+  static_assert(sizeof(PaletteColor) == 3 * sizeof(float), "palette entries are uploaded as packed RGB");
+  glBindTexture(GL_TEXTURE_1D, paletteTexture);
+  glTexImage1D(GL_TEXTURE_1D, 0, GL_RGB32F, static_cast<GLsizei>(count), 0, GL_RGB, GL_FLOAT, colors);
+  glBindTexture(GL_TEXTURE_1D, 0);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ColorPalette.h"
+#include "StreamBuffer.h"
+
+// GL half of the light field: the grid texture, the quad it is drawn on, the colormap and
+// the staging ring uploads go through. GL thread only. It never sees the LightFieldGrid
+// itself, just the resolved intensities and tile change frames the simulation thread
+// hands over, so the two halves cannot be touched from the wrong thread.
+class LightFieldView {
+public:
+  // resolution cells per side, drawn over the square of side worldSize centred on the origin
+  LightFieldView(int resolution, float worldSize);
+  ~LightFieldView();
+
+  // Create the GL objects; returns false if any could not be allocated
+  bool Initialize();
+
+  // Copy resolved intensities into the grid texture, with the display mapping they are
+  // to be drawn with. They are staged in a mapped pixel unpack buffer, so the texture
+  // update is a GPU-side copy. Only tiles changed since the last upload are sent:
+  // displayData was resolved in display frame `frame`, and changeFrames and visibleTiles
+  // are the LightFieldGrid::GetTileChangeFrames() and GetTileVisible() snapshots taken
+  // with it. Tiles that are not visible are sent as zeros, without reading displayData.
+  void Upload(const std::vector<float>& displayData, const std::vector<uint32_t>& changeFrames,
+    const std::vector<uint8_t>& visibleTiles, uint32_t frame, float threshold, float brightness);
+
+  // Draw the grid as one quad textured with the last upload. The fragment shader maps
+  // intensity to colour: u_DisplayThreshold and u_MaxBrightness bound the ramp, the
+  // single-channel texture u_Intensity is sampled per cell, and the colour is looked up
+  // in the 1D palette texture u_Palette.
+  void Render(unsigned int shaderProgram);
+
+  // Replace the colormap with count (2 to MAX_PALETTE_SIZE) entries spread evenly from the
+  // display threshold to the max brightness. Initialize sets HEAT_PALETTE.
+  void SetPalette(const PaletteColor* colors, size_t count);
+
+private:
+  int resolution;         // Cells per side
+  int tilesPerSide;       // LightFieldGrid tiles per side (the layout of changeFrames)
+  float worldSize;
+
+  unsigned int VAO;
+  unsigned int quadVBO;   // Unit quad covering the grid
+  unsigned int texture;   // One R32F texel per cell
+  unsigned int paletteTexture;  // 1D RGB32F colormap, linearly filtered
+  float drawThreshold;    // Display mapping of the last upload
+  float drawMaxBrightness;
+  uint32_t uploadedFrame; // Display frame the texture holds
+  StreamBuffer uploadStream;  // Pixel unpack ring the changed tiles are staged in
+  struct UploadRun {          // Changed tiles next to each other in one tile row
+    int x, y, width, height;  // Cells covered
+    size_t offset;            // Byte offset of the packed cells in the staged region
+  };
+  std::vector<UploadRun> uploadRuns;
+};
@@ -0,0 +1,684 @@
+#include "RayBatch.h"
+#include "LightRay.h"
+#include <algorithm>
+#include <cmath>
+
+RayBatch::RayBatch(int capacity, uint64_t randomSeed)
+  : minSpeed(0.0f)
+  , maxSpeed(0.0f)
+  , replayEnabled(true)
+  , capturePrediction(true)
+  , respawnHead(0)
+  , respawnCount(0)
+  , respawnBudget(1024)
+  , trailCapacity(static_cast<uint32_t>(std::max(capacity, 2)))
+  , simdLevel(DetectSimdLevel())
+  , stepKernel(GetGeodesicStepKernel(simdLevel))
+  , resetKernel(GetRayResetKernel(simdLevel))
+  , integrator(IntegratorType::Euler)
+  , seed(randomSeed) {
+}
+
+void RayBatch::SetSimdLevel(SimdLevel level) {
+  simdLevel = ClampSimdLevel(level);
+  stepKernel = GetGeodesicStepKernel(simdLevel);
+  resetKernel = GetRayResetKernel(simdLevel);
+}
+
+void RayBatch::Clear() {
+  posX.clear();
+  posY.clear();
+  velX.clear();
+  velY.clear();
+  speed.clear();
+  angularMomentum.clear();
+  properTime.clear();
+  absorbTimer.clear();
+  absorbed.clear();
+  stepSize.clear();
+  startX.clear();
+  startY.clear();
+  launchAngle.clear();
+  replaying.clear();
+  replayImpact.clear();
+  replayCos.clear();
+  replaySin.clear();
+  replayTime.clear();
+  replayCapture.clear();
+  replayTauOffset.clear();
+  doomed.clear();
+  coasting.clear();
+  coastTime.clear();
+  coastWindow.clear();
+  coastX.clear();
+  coastY.clear();
+  coastVX.clear();
+  coastVY.clear();
+  coastAX.clear();
+  coastAY.clear();
+  coastTau.clear();
+  coastTauRate.clear();
+  coastTauAccel.clear();
+  respawnPending.clear();
+  respawnRing.clear();
+  respawnHead = 0;
+  respawnCount = 0;
+  resetDirX.clear();
+  resetDirY.clear();
+  trailSlab.clear();
+  trailHead.clear();
+  trailCount.clear();
+  resetGeneration.clear();
+}
+
+void RayBatch::Reserve(size_t count) {
+  posX.reserve(count);
+  posY.reserve(count);
+  velX.reserve(count);
+  velY.reserve(count);
+  speed.reserve(count);
+  angularMomentum.reserve(count);
+  properTime.reserve(count);
+  absorbTimer.reserve(count);
+  absorbed.reserve(count);
+  stepSize.reserve(count);
+  startX.reserve(count);
+  startY.reserve(count);
+  launchAngle.reserve(count);
+  replaying.reserve(count);
+  replayImpact.reserve(count);
+  replayCos.reserve(count);
+  replaySin.reserve(count);
+  replayTime.reserve(count);
+  replayCapture.reserve(count);
+  replayTauOffset.reserve(count);
+  doomed.reserve(count);
+  coasting.reserve(count);
+  coastTime.reserve(count);
+  coastWindow.reserve(count);
+  coastX.reserve(count);
+  coastY.reserve(count);
+  coastVX.reserve(count);
+  coastVY.reserve(count);
+  coastAX.reserve(count);
+  coastAY.reserve(count);
+  coastTau.reserve(count);
+  coastTauRate.reserve(count);
+  coastTauAccel.reserve(count);
+  respawnPending.reserve(count);
+  respawnRing.reserve(count);
+  resetDirX.reserve(count);
+  resetDirY.reserve(count);
+  trailSlab.reserve(count * trailCapacity);
+  trailHead.reserve(count);
+  trailCount.reserve(count);
+  resetGeneration.reserve(count);
+}
+
+size_t RayBatch::AddRay(glm::vec2 startPos, float raySpeed, float angle) {
+  size_t index = Size();
+  minSpeed = index == 0 ? raySpeed : std::min(minSpeed, raySpeed);
+  maxSpeed = index == 0 ? raySpeed : std::max(maxSpeed, raySpeed);
+
+  posX.push_back(0.0f);
+  posY.push_back(0.0f);
+  velX.push_back(0.0f);
+  velY.push_back(0.0f);
+  speed.push_back(raySpeed);
+  angularMomentum.push_back(0.0f);
+  properTime.push_back(0.0f);
+  absorbTimer.push_back(0.0f);
+  absorbed.push_back(0);
+  stepSize.push_back(0.0f);
+  startX.push_back(startPos.x);
+  startY.push_back(startPos.y);
+  launchAngle.push_back(angle);
+  replaying.push_back(0);
+  replayImpact.push_back(0.0f);
+  replayCos.push_back(1.0f);
+  replaySin.push_back(0.0f);
+  replayTime.push_back(0.0f);
+  replayCapture.push_back(0.0f);
+  replayTauOffset.push_back(0.0f);
+  doomed.push_back(0);
+  coasting.push_back(0);
+  coastTime.push_back(0.0f);
+  coastWindow.push_back(0.0f);
+  coastX.push_back(0.0f);
+  coastY.push_back(0.0f);
+  coastVX.push_back(0.0f);
+  coastVY.push_back(0.0f);
+  coastAX.push_back(0.0f);
+  coastAY.push_back(0.0f);
+  coastTau.push_back(0.0f);
+  coastTauRate.push_back(0.0f);
+  coastTauAccel.push_back(0.0f);
+  respawnPending.push_back(0);
+  resetDirX.push_back(0.0f);
+  resetDirY.push_back(0.0f);
+  trailSlab.resize(trailSlab.size() + trailCapacity);
+  trailHead.push_back(0);
+  trailCount.push_back(0);
+  resetGeneration.push_back(0);
+
+  // Adding a ray grows the ring; move queued entries so they stay contiguous
+  std::rotate(respawnRing.begin(), respawnRing.begin() + respawnHead, respawnRing.end());
+  respawnHead = 0;
+  respawnRing.push_back(0);
+
+  Reset(index);
+  return index;
+}
+
+void RayBatch::Reset(size_t i) {
+  uint32_t index = static_cast<uint32_t>(i);
+  ResetRays(&index, 1);
+}
+
+void RayBatch::ResetRays(const uint32_t* indices, size_t count) {
+  // Pass 1: head state. The rays are gathered into contiguous lanes a block at a time so
+  // the reset kernel can draw their jitter (Philox) and launch directions (sin/cos)
+  // several rays per instruction, then scattered back.
+  // Jitter: start positions by up to 0.02 in x and y, launch angles by up to 0.03 rad
+  const RayResetParams params = { seed, RANDOM_STREAM_RESET, 0.02f, 0.03f };
+  for (size_t blockBegin = 0; blockBegin < count; blockBegin += RESET_BLOCK) {
+    const uint32_t* block = indices + blockBegin;
+    size_t n = std::min(count - blockBegin, RESET_BLOCK);
+
+    alignas(64) uint32_t generation[RESET_BLOCK];
+    alignas(64) float inStartX[RESET_BLOCK], inStartY[RESET_BLOCK], inAngle[RESET_BLOCK], inSpeed[RESET_BLOCK];
+    alignas(64) float outPosX[RESET_BLOCK], outPosY[RESET_BLOCK], outVelX[RESET_BLOCK], outVelY[RESET_BLOCK];
+    alignas(64) float outDirX[RESET_BLOCK], outDirY[RESET_BLOCK], outL[RESET_BLOCK];
+    for (size_t k = 0; k < n; ++k) {
+      uint32_t i = block[k];
+      absorbed[i] = 0;
+      absorbTimer[i] = 0.0f;
+      properTime[i] = 0.0f;
+      stepSize[i] = 0.0f;
+      coasting[i] = 0;
+
+      generation[k] = resetGeneration[i]++;
+      inStartX[k] = startX[i];
+      inStartY[k] = startY[i];
+      inAngle[k] = launchAngle[i];
+      inSpeed[k] = speed[i];
+    }
+
+    RayResetLanes lanes = { block, generation, inStartX, inStartY, inAngle, inSpeed,
+      outPosX, outPosY, outVelX, outVelY, outDirX, outDirY, outL };
+    resetKernel(lanes, 0, n, params);
+
+    for (size_t k = 0; k < n; ++k) {
+      uint32_t i = block[k];
+      posX[i] = outPosX[k];
+      posY[i] = outPosY[k];
+      velX[i] = outVelX[k];
+      velY[i] = outVelY[k];
+      resetDirX[i] = outDirX[k];
+      resetDirY[i] = outDirY[k];
+      angularMomentum[i] = outL[k];
+    }
+  }
+
+  // Pass 2: initial trail extending backwards from the start position, written straight
+  // into the ring slots (oldest point first, newest at the head)
+  const float segmentLength = 0.02f;
+  const uint32_t trailPoints = std::min<uint32_t>(50, trailCapacity);
+  for (size_t k = 0; k < count; ++k) {
+    uint32_t i = indices[k];
+    glm::vec2 head(posX[i], posY[i]);
+    glm::vec2 step = glm::vec2(resetDirX[i], resetDirY[i]) * segmentLength;
+    glm::vec2* ring = trailSlab.data() + static_cast<size_t>(i) * trailCapacity;
+    for (uint32_t s = 0; s < trailPoints; ++s) {
+      ring[s] = head - step * static_cast<float>(trailPoints - 1 - s);
+    }
+    trailHead[i] = trailPoints - 1;
+    trailCount[i] = trailPoints;
+  }
+
+  // Pass 3: doomed rays skip integration entirely; the rest may replay a cached path
+  for (size_t k = 0; k < count; ++k) {
+    uint32_t i = indices[k];
+    replaying[i] = 0;
+    doomed[i] = PredictCapture(i, resetDirX[i], resetDirY[i]) ? 1 : 0;
+    if (!doomed[i]) BeginReplay(i, resetDirX[i], resetDirY[i]);
+  }
+}
+
+void RayBatch::QueueRespawn(size_t i) {
+  if (respawnPending[i]) return;
+  respawnPending[i] = 1;
+  size_t tail = respawnHead + respawnCount;
+  if (tail >= respawnRing.size()) tail -= respawnRing.size();
+  respawnRing[tail] = static_cast<uint32_t>(i);
+  respawnCount++;
+}
+
+void RayBatch::RespawnAll() {
+  for (size_t i = 0; i < Size(); ++i) {
+    QueueRespawn(i);
+  }
+}
+
+size_t RayBatch::ProcessRespawns() {
+  size_t processed = 0;
+  size_t budget = std::min(respawnBudget, respawnCount);
+
+  // The queued block may wrap around the end of the ring: reset it in up to two runs
+  while (processed < budget) {
+    size_t run = std::min(budget - processed, respawnRing.size() - respawnHead);
+    const uint32_t* indices = respawnRing.data() + respawnHead;
+    ResetRays(indices, run);
+    for (size_t k = 0; k < run; ++k) {
+      respawnPending[indices[k]] = 0;
+    }
+
+    processed += run;
+    respawnHead += run;
+    if (respawnHead == respawnRing.size()) respawnHead = 0;
+  }
+
+  respawnCount -= processed;
+  return processed;
+}
+
+void RayBatch::SetSeed(uint64_t randomSeed) {
+  seed = randomSeed;
+  std::fill(resetGeneration.begin(), resetGeneration.end(), 0u);
+}
+
+void RayBatch::SetSpeed(float s) {
+  std::fill(speed.begin(), speed.end(), s);
+  minSpeed = maxSpeed = s;
+
+  // Open weak-field windows were fitted for the old speed
+  for (size_t i = 0; i < Size(); ++i) {
+    if (coasting[i]) EndCoast(i);
+  }
+
+  // Cached paths and capture predictions were made for the old speeds
+  std::fill(replaying.begin(), replaying.end(), uint8_t(0));
+  std::fill(doomed.begin(), doomed.end(), uint8_t(0));
+}
+
+void RayBatch::SetWeakFieldSettings(const WeakFieldSettings& settings) {
+  for (size_t i = 0; i < Size(); ++i) {
+    if (coasting[i]) EndCoast(i);
+  }
+  weakField = settings;
+}
+
+size_t RayBatch::CountCoasting() const {
+  size_t count = 0;
+  for (uint8_t flag : coasting) count += flag;
+  return count;
+}
+
+void RayBatch::SetTrajectoryTable(std::shared_ptr<const TrajectoryTable> table) {
+  if (table == trajectoryTable) return;
+
+  // Rays mid-replay already hold their latest position and velocity, so the integrator takes over
+  std::fill(replaying.begin(), replaying.end(), uint8_t(0));
+  std::fill(doomed.begin(), doomed.end(), uint8_t(0));
+  trajectoryTable = std::move(table);
+}
+
+void RayBatch::SetReplayEnabled(bool enabled) {
+  replayEnabled = enabled;
+  if (!enabled) std::fill(replaying.begin(), replaying.end(), uint8_t(0));
+}
+
+void RayBatch::SetCapturePrediction(bool enabled) {
+  capturePrediction = enabled;
+  if (!enabled) std::fill(doomed.begin(), doomed.end(), uint8_t(0));
+}
+
+size_t RayBatch::CountReplaying() const {
+  size_t count = 0;
+  for (uint8_t flag : replaying) count += flag;
+  return count;
+}
+
+size_t RayBatch::CountDoomed() const {
+  size_t count = 0;
+  for (uint8_t flag : doomed) count += flag;
+  return count;
+}
+
+bool RayBatch::PredictCapture(size_t i, float dirX, float dirY) const {
+  if (!capturePrediction || !trajectoryTable) return false;
+
+  // Only rays still approaching the hole; impact parameter as in BeginReplay
+  float along = posX[i] * dirX + posY[i] * dirY;
+  float impact = dirX * posY[i] - dirY * posX[i];
+  if (along >= 0.0f) return false;
+
+  return trajectoryTable->PredictCapture(impact, speed[i]);
+}
+
+void RayBatch::BeginReplay(size_t i, float dirX, float dirY) {
+  replaying[i] = 0;
+  if (!replayEnabled || !trajectoryTable) return;
+
+  // Express the spawn point in the canonical frame of its launch direction
+  float along = posX[i] * dirX + posY[i] * dirY;
+  float impact = dirX * posY[i] - dirY * posX[i];
+  if (along < TrajectoryTable::START_X) return;
+
+  float startTime = (along - TrajectoryTable::START_X) / speed[i];
+  float captureTime;
+  if (!trajectoryTable->Lookup(impact, speed[i], startTime, captureTime)) return;
+
+  glm::vec2 position, velocity;
+  float tau;
+  trajectoryTable->Sample(impact, speed[i], startTime, position, velocity, tau);
+
+  replaying[i] = 1;
+  replayImpact[i] = impact;
+  replayCos[i] = dirX;
+  replaySin[i] = dirY;
+  replayTime[i] = startTime;
+  replayCapture[i] = captureTime;
+  replayTauOffset[i] = tau;
+}
+
+void RayBatch::BeginUpdate() {
+  activeMask.resize(Size());
+  integrateMask.resize(Size());
+  resetMask.resize(Size());
+  respawnMask.resize(Size());
+}
+
+void RayBatch::Update(size_t begin, size_t end, float deltaTime, glm::vec2 blackholePos,
+  float blackholeMass, float eventHorizon, float cullRadius) {
+  // Skip rays that are far from view (absorbed rays keep ticking their timer)
+  // and rays parked in the respawn queue
+  for (size_t i = begin; i < end; ++i) {
+    TrailView trail = GetTrail(i);
+    bool culled = !trail.empty() && !absorbed[i] && glm::length(trail.front()) > cullRadius;
+    activeMask[i] = (culled || respawnPending[i]) ? 0 : 1;
+  }
+
+  // Replayed and doomed rays have known outcomes; everything else is integrated. The mask
+  // is taken before they advance: one captured this step must not tick its absorption
+  // timer in the same step, just as an integrated capture does not
+  for (size_t i = begin; i < end; ++i) {
+    integrateMask[i] = activeMask[i] && !replaying[i] && !doomed[i];
+  }
+  ReplayRays(begin, end, activeMask.data(), deltaTime);
+  FastForwardRays(begin, end, activeMask.data(), deltaTime, blackholePos, blackholeMass, eventHorizon);
+
+  // Far from the hole the remaining rays move in closed form; only the strong field is integrated
+  CoastRays(begin, end, integrateMask.data(), MakeStepParams(deltaTime, blackholePos, blackholeMass, eventHorizon));
+  for (size_t i = begin; i < end; ++i) {
+    integrateMask[i] = integrateMask[i] && !coasting[i];
+  }
+  PropagateRays(begin, end, integrateMask.data(), deltaTime, blackholePos, blackholeMass, eventHorizon);
+  UpdateTrails(begin, end, activeMask.data());
+
+  // Rays that left the view or were absorbed for too long are marked for EndUpdate
+  NeedsReset(begin, end, activeMask.data(), resetMask.data());
+  ShouldRespawn(begin, end, activeMask.data(), respawnMask.data());
+  for (size_t i = begin; i < end; ++i) {
+    resetMask[i] |= respawnMask[i];
+  }
+}
+
+void RayBatch::EndUpdate() {
+  // Queue in index order, whichever thread marked the ray
+  for (size_t i = 0; i < resetMask.size(); ++i) {
+    if (resetMask[i]) QueueRespawn(i);
+  }
+}
+
+GeodesicStepParams RayBatch::MakeStepParams(float deltaTime, glm::vec2 blackholePos,
+  float blackholeMass, float eventHorizon) const {
+  GeodesicStepParams params;
+  params.deltaTime = deltaTime;
+  params.blackholeX = blackholePos.x;
+  params.blackholeY = blackholePos.y;
+  params.blackholeMass = blackholeMass;
+  params.eventHorizon = eventHorizon;
+  params.gravityMultiplier = LightRay::GetGravityMultiplier();
+  params.maxForce = LightRay::GetMaxForce();
+  params.minDistance = LightRay::GetMinDistance();
+  return params;
+}
+
+void RayBatch::PropagateRays(size_t begin, size_t end, const uint8_t* mask, float deltaTime,
+  glm::vec2 blackholePos, float blackholeMass, float eventHorizon) {
+  GeodesicStepArrays arrays = {
+    posX.data(), posY.data(), velX.data(), velY.data(), speed.data(),
+    angularMomentum.data(), properTime.data(), absorbTimer.data(), absorbed.data(), mask
+  };
+  GeodesicStepParams params = MakeStepParams(deltaTime, blackholePos, blackholeMass, eventHorizon);
+
+  if (integrator == IntegratorType::Euler) {
+    stepKernel(arrays, begin, end, params);
+  }
+  else {
+    IntegrateRays(integrator, arrays, stepSize.data(), begin, end, params, integratorSettings);
+  }
+}
+
+void RayBatch::CoastRays(size_t begin, size_t end, const uint8_t* mask, const GeodesicStepParams& params) {
+  if (!weakField.enabled) return;
+  float switchRadius2 = weakField.switchRadius * weakField.switchRadius;
+
+  for (size_t i = begin; i < end; ++i) {
+    if (!mask[i] || absorbed[i]) continue;
+
+    // Close the window once it has run its length or the ray reaches the switch radius
+    if (coasting[i]) {
+      float dx = posX[i] - params.blackholeX;
+      float dy = posY[i] - params.blackholeY;
+      if (coastTime[i] >= coastWindow[i] || dx * dx + dy * dy < switchRadius2) EndCoast(i);
+    }
+    if (!coasting[i] && !BeginCoast(i, params)) continue;
+
+    // No sqrt or force evaluation inside a window
+    float t = coastTime[i] + params.deltaTime;
+    coastTime[i] = t;
+    posX[i] = coastX[i] + (coastVX[i] + 0.5f * coastAX[i] * t) * t;
+    posY[i] = coastY[i] + (coastVY[i] + 0.5f * coastAY[i] * t) * t;
+    properTime[i] = coastTau[i] + (coastTauRate[i] + 0.5f * coastTauAccel[i] * t) * t;
+  }
+}
+
+bool RayBatch::BeginCoast(size_t i, const GeodesicStepParams& params) {
+  glm::vec2 blackholePos(params.blackholeX, params.blackholeY);
+  glm::vec2 position(posX[i], posY[i]);
+  glm::vec2 velocity(velX[i], velY[i]);
+  glm::vec2 offset = position - blackholePos;
+  float r = glm::length(offset);
+
+  // Closed form only where time dilation is mild (and below its clamp)
+  float rs = 2.0f * params.blackholeMass;
+  if (r <= weakField.switchRadius || r <= 2.0f * rs) return false;
+
+  // Frame-time motion: p' = v / gamma, so p'' = a / gamma^2 + v d(1/gamma)/dt.
+  // Speed is renormalized every step, so only the force across the ray bends it.
+  float invDilation = 1.0f / LightRay::CalculateTimeDilation(r, params.blackholeMass);
+  glm::vec2 acceleration = LightRay::CalculateGeodesicDeflection(position, velocity,
+    blackholePos, params.blackholeMass, angularMomentum[i],
+    params.gravityMultiplier, params.maxForce, params.minDistance);
+  float speed2 = glm::dot(velocity, velocity);
+  if (speed2 > 0.0f) acceleration -= velocity * (glm::dot(acceleration, velocity) / speed2);
+  float radialRate = glm::dot(offset, velocity) / r * invDilation;
+  float invDilationRate = rs / (2.0f * r * r) / invDilation * radialRate;
+
+  glm::vec2 frameVelocity = velocity * invDilation;
+  glm::vec2 frameAcceleration = acceleration * (invDilation * invDilation) + velocity * invDilationRate;
+
+  // The dropped cubic term is jerk * t^3 / 6; the force falls off no faster than 1/r^3,
+  // so jerk is at most about 3 |a| |v| / r
+  float jerk = 3.0f * glm::length(frameAcceleration) * glm::length(frameVelocity) / r;
+  float window = jerk > 0.0f ? std::cbrt(6.0f * weakField.tolerance / jerk) : weakField.maxWindow;
+  window = std::min(window, weakField.maxWindow);
+  if (window < params.deltaTime) return false;
+
+  coasting[i] = 1;
+  coastTime[i] = 0.0f;
+  coastWindow[i] = window;
+  coastX[i] = position.x;
+  coastY[i] = position.y;
+  coastVX[i] = frameVelocity.x;
+  coastVY[i] = frameVelocity.y;
+  coastAX[i] = frameAcceleration.x;
+  coastAY[i] = frameAcceleration.y;
+  coastTau[i] = properTime[i];
+  coastTauRate[i] = invDilation;
+  coastTauAccel[i] = invDilationRate;
+  return true;
+}
+
+void RayBatch::EndCoast(size_t i) {
+  // Direction from the fitted frame velocity; light keeps its base speed
+  float t = coastTime[i];
+  glm::vec2 velocity(coastVX[i] + coastAX[i] * t, coastVY[i] + coastAY[i] * t);
+  float length = glm::length(velocity);
+  if (length > 0.001f) {
+    velX[i] = velocity.x / length * speed[i];
+    velY[i] = velocity.y / length * speed[i];
+  }
+  angularMomentum[i] = posX[i] * velY[i] - posY[i] * velX[i];
+  coasting[i] = 0;
+}
+
+void RayBatch::ReplayRays(size_t begin, size_t end, const uint8_t* mask, float deltaTime) {
+  if (!trajectoryTable) return;
+
+  for (size_t i = begin; i < end; ++i) {
+    if (!mask[i] || !replaying[i]) continue;
+
+    float t = replayTime[i] + deltaTime;
+    bool captured = t >= replayCapture[i];
+    if (captured) t = replayCapture[i];
+    replayTime[i] = t;
+
+    glm::vec2 position, velocity;
+    float tau;
+    trajectoryTable->Sample(replayImpact[i], speed[i], t, position, velocity, tau);
+
+    // Rotate from the canonical frame onto the launch direction
+    float c = replayCos[i];
+    float s = replaySin[i];
+    posX[i] = c * position.x - s * position.y;
+    posY[i] = s * position.x + c * position.y;
+    velX[i] = c * velocity.x - s * velocity.y;
+    velY[i] = s * velocity.x + c * velocity.y;
+    angularMomentum[i] = posX[i] * velY[i] - posY[i] * velX[i];
+    properTime[i] = tau - replayTauOffset[i];
+
+    // Captured: hand over to the regular absorption timer
+    if (captured) {
+      absorbed[i] = 1;
+      absorbTimer[i] = 0.0f;
+      replaying[i] = 0;
+    }
+  }
+}
+
+void RayBatch::FastForwardRays(size_t begin, size_t end, const uint8_t* mask, float deltaTime,
+  glm::vec2 blackholePos, float blackholeMass, float eventHorizon) {
+  float strongField = std::max(STRONG_FIELD_SCALE * 2.0f * blackholeMass, eventHorizon);
+
+  for (size_t i = begin; i < end; ++i) {
+    if (!mask[i] || !doomed[i]) continue;
+
+    // Weak field: straight line, slowed by time dilation like the integrated rays
+    glm::vec2 offset(posX[i] - blackholePos.x, posY[i] - blackholePos.y);
+    float r = glm::length(offset);
+    float effectiveDeltaTime = deltaTime / LightRay::CalculateTimeDilation(r, blackholeMass);
+    posX[i] += velX[i] * effectiveDeltaTime;
+    posY[i] += velY[i] * effectiveDeltaTime;
+    properTime[i] += effectiveDeltaTime;
+
+    // Entering the strong field: skip the rest and freeze at the event horizon
+    offset = glm::vec2(posX[i] - blackholePos.x, posY[i] - blackholePos.y);
+    r = glm::length(offset);
+    if (r < strongField) {
+      glm::vec2 frozen = blackholePos + (r > 0.0f ? offset / r : glm::vec2(1.0f, 0.0f)) * eventHorizon;
+      posX[i] = frozen.x;
+      posY[i] = frozen.y;
+      absorbed[i] = 1;
+      absorbTimer[i] = 0.0f;
+      doomed[i] = 0;
+    }
+  }
+}
+
+void RayBatch::UpdateTrails(size_t begin, size_t end, const uint8_t* mask) {
+  for (size_t i = begin; i < end; ++i) {
+    // Trails stay frozen while absorbed
+    if (!mask[i] || absorbed[i]) continue;
+
+    // Only add if moved enough distance from the last point
+    glm::vec2 head(posX[i], posY[i]);
+    if (trailCount[i] == 0 || glm::length(head - GetTrail(i).front()) > 0.01f) {
+      PushTrail(i, head);
+    }
+  }
+}
+
+void RayBatch::NeedsReset(size_t begin, size_t end, const uint8_t* mask, uint8_t* out) const {
+  const float maxVisible = 2.0f;  // Extended visibility range for radial pattern
+
+  for (size_t i = begin; i < end; ++i) {
+    out[i] = 0;
+    if (!mask[i]) continue;
+
+    TrailView trail = GetTrail(i);
+    if (trail.empty()) {
+      out[i] = 1;
+      continue;
+    }
+
+    // Absorbed rays reset via ShouldRespawn instead
+    if (absorbed[i]) continue;
+
+    // Reset if ray has gone far off screen
+    if (std::sqrt(posX[i] * posX[i] + posY[i] * posY[i]) > 2.5f) {
+      out[i] = 1;
+      continue;
+    }
+
+    // At least some part of the recent trail should be visible
+    bool anyVisible = false;
+    size_t count = std::min(size_t(20), trail.size());
+    for (size_t s = 0; s < count; ++s) {
+      if (std::abs(trail[s].x) <= maxVisible && std::abs(trail[s].y) <= maxVisible) {
+        anyVisible = true;
+        break;
+      }
+    }
+    out[i] = anyVisible ? 0 : 1;
+  }
+}
+
+void RayBatch::ShouldRespawn(size_t begin, size_t end, const uint8_t* mask, uint8_t* out) const {
+  for (size_t i = begin; i < end; ++i) {
+    out[i] = (mask[i] && absorbed[i] && absorbTimer[i] > LightRay::ABSORPTION_RESPAWN_TIME) ? 1 : 0;
+  }
+}
+
+bool RayBatch::IsOrbiting(size_t index) const {
+  TrailView trail = GetTrail(index);
+  if (trail.size() < 10) return false;
+
+  // Low variance in radius around the origin means a roughly circular path
+  float avgRadius = 0.0f;
+  for (size_t s = 0; s < 10; ++s) {
+    avgRadius += glm::length(trail[s]);
+  }
+  avgRadius /= 10.0f;
+
+  float variance = 0.0f;
+  for (size_t s = 0; s < 10; ++s) {
+    float r = glm::length(trail[s]);
+    variance += (r - avgRadius) * (r - avgRadius);
+  }
+  variance /= 10.0f;
+
+  return variance < 0.01f && avgRadius < 0.5f;
+}
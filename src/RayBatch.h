@@ -0,0 +1,243 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "AlignedAllocator.h"
+#include "CounterRng.h"
+#include "GeodesicKernel.h"
+#include "Integrators.h"
+#include "RayResetKernel.h"
+#include "TrailView.h"
+#include "TrajectoryCache.h"
+
+// Structure-of-arrays storage for all light rays.
+// Per-ray state lives in contiguous aligned arrays so the update kernels
+// sweep memory linearly instead of chasing one heap object per ray.
+class RayBatch {
+public:
+  // Rays predicted to be captured are absorbed once they come this close (in Schwarzschild radii);
+  // 1.5 rs is the photon sphere, inside which the integrator needs its smallest steps
+  static constexpr float STRONG_FIELD_SCALE = 1.5f;
+
+  static const uint64_t DEFAULT_SEED = 0x5EEDB1AC40135EEDull;
+
+  // Every ray keeps the newest trailCapacity head positions
+  explicit RayBatch(int trailCapacity = 64, uint64_t seed = DEFAULT_SEED);
+
+  // Remove all rays
+  void Clear();
+
+  // Pre-allocate storage (including the trail slab) for a number of rays
+  void Reserve(size_t count);
+
+  // Add a ray and reset it to its starting position; returns its index
+  size_t AddRay(glm::vec2 startPos, float speed, float angle);
+
+  // Number of rays in the batch
+  size_t Size() const { return posX.size(); }
+
+  // Reset one ray to its starting position. Touches only that ray (safe to run for
+  // different rays in parallel); its jitter depends only on (seed, index, generation).
+  void Reset(size_t index);
+
+  // Reset a list of rays in bulk (no allocation; indices must be distinct). The jitter
+  // draws and launch directions run through the vectorized reset kernel.
+  void ResetRays(const uint32_t* indices, size_t count);
+
+  // Respawn queue: Update parks rays that need a reset here instead of resetting them
+  // inline, and ProcessRespawns restarts at most the per-call budget, oldest first.
+  // A parked ray is skipped by Update and stays parked until its turn.
+  void QueueRespawn(size_t index);
+  void RespawnAll();
+  size_t ProcessRespawns();
+  void SetRespawnBudget(size_t budget) { respawnBudget = budget; }
+  size_t GetRespawnBudget() const { return respawnBudget; }
+  size_t CountPendingRespawns() const { return respawnCount; }
+  bool IsRespawnPending(size_t index) const { return respawnPending[index] != 0; }
+  // Marked by this step's Update (valid between Update and the next BeginUpdate)
+  bool IsMarkedForRespawn(size_t index) const { return resetMask[index] != 0; }
+
+  // Seed for the reset jitter; generations restart so the sequence replays from the top
+  void SetSeed(uint64_t seed);
+  uint64_t GetSeed() const { return seed; }
+
+  // Set the base speed of every ray
+  void SetSpeed(float speed);
+
+  // Select the propagation kernel (clamped to what the CPU supports)
+  void SetSimdLevel(SimdLevel level);
+  SimdLevel GetSimdLevel() const { return simdLevel; }
+
+  // Select the integration scheme (Euler uses the vectorized kernel)
+  void SetIntegrator(IntegratorType type) { integrator = type; }
+  IntegratorType GetIntegrator() const { return integrator; }
+  void SetIntegratorSettings(const IntegratorSettings& settings) { integratorSettings = settings; }
+  const IntegratorSettings& GetIntegratorSettings() const { return integratorSettings; }
+
+  // Weak-field fast path: rays outside settings.switchRadius move in closed form
+  void SetWeakFieldSettings(const WeakFieldSettings& settings);
+  const WeakFieldSettings& GetWeakFieldSettings() const { return weakField; }
+
+  // Number of rays currently in a closed-form weak-field window
+  size_t CountCoasting() const;
+
+  // Table used to replay newly spawned rays instead of integrating them (null disables replay).
+  // Switching tables hands rays that are mid-replay back to the integrator.
+  void SetTrajectoryTable(std::shared_ptr<const TrajectoryTable> table);
+
+  // Replay cached paths for rays the table covers (on by default)
+  void SetReplayEnabled(bool enabled);
+  bool IsReplayEnabled() const { return replayEnabled; }
+
+  // Classify rays at reset and fast-forward the ones the table says are captured (on by default)
+  void SetCapturePrediction(bool enabled);
+  bool IsCapturePredictionEnabled() const { return capturePrediction; }
+
+  // Range of per-ray speeds (the trajectory table must cover it)
+  float GetMinSpeed() const { return minSpeed; }
+  float GetMaxSpeed() const { return maxSpeed; }
+
+  // Number of rays currently following a cached trajectory
+  size_t CountReplaying() const;
+
+  // Number of rays currently flying straight towards a predicted capture
+  size_t CountDoomed() const;
+
+  // Per-step update, in three phases:
+  //   BeginUpdate() sizes the scratch masks;
+  //   Update(begin, end, ...) culls, propagates and extends trails for rays [begin, end)
+  //     and marks the ones to respawn. It touches only those rays, so disjoint ranges
+  //     may run on different threads;
+  //   EndUpdate() queues the marked rays for ProcessRespawns, in index order.
+  void BeginUpdate();
+  void Update(size_t begin, size_t end, float deltaTime, glm::vec2 blackholePos,
+    float blackholeMass, float eventHorizon, float cullRadius);
+  void EndUpdate();
+
+  // Batch kernels over [begin, end), restricted to rays whose mask byte is set
+  void PropagateRays(size_t begin, size_t end, const uint8_t* mask, float deltaTime,
+    glm::vec2 blackholePos, float blackholeMass, float eventHorizon);
+  void ReplayRays(size_t begin, size_t end, const uint8_t* mask, float deltaTime);
+  void FastForwardRays(size_t begin, size_t end, const uint8_t* mask, float deltaTime,
+    glm::vec2 blackholePos, float blackholeMass, float eventHorizon);
+  void CoastRays(size_t begin, size_t end, const uint8_t* mask, const GeodesicStepParams& params);
+  void UpdateTrails(size_t begin, size_t end, const uint8_t* mask);
+  void NeedsReset(size_t begin, size_t end, const uint8_t* mask, uint8_t* out) const;
+  void ShouldRespawn(size_t begin, size_t end, const uint8_t* mask, uint8_t* out) const;
+
+  // Per-ray accessors
+  glm::vec2 GetHeadPosition(size_t index) const { return glm::vec2(posX[index], posY[index]); }
+  glm::vec2 GetHeadVelocity(size_t index) const { return glm::vec2(velX[index], velY[index]); }
+  float GetProperTime(size_t index) const { return properTime[index]; }
+  bool IsAbsorbed(size_t index) const { return absorbed[index] != 0; }
+  TrailView GetTrail(size_t index) const {
+    return TrailView(trailSlab.data() + index * trailCapacity, trailCapacity,
+      trailHead[index], trailCount[index]);
+  }
+  bool IsOrbiting(size_t index) const;
+
+private:
+  // Head state
+  AlignedVector<float> posX, posY;       // Current position of ray head
+  AlignedVector<float> velX, velY;       // Current velocity of ray head
+  AlignedVector<float> speed;            // Base speed (speed of light)
+  AlignedVector<float> angularMomentum;  // Conserved angular momentum
+  AlignedVector<float> properTime;       // Proper time along ray's path
+  AlignedVector<float> absorbTimer;      // Time since ray was absorbed
+  AlignedVector<uint8_t> absorbed;       // Has the ray been absorbed?
+  AlignedVector<float> stepSize;         // Last accepted adaptive step (0 = none yet)
+
+  // Spawn parameters
+  AlignedVector<float> startX, startY;   // Full starting position
+  AlignedVector<float> launchAngle;      // Initial launch angle
+
+  // Cached trajectory replay
+  AlignedVector<uint8_t> replaying;      // Following a cached path instead of integrating
+  AlignedVector<float> replayImpact;     // Signed impact parameter
+  AlignedVector<float> replayCos, replaySin;  // Rotation from the canonical frame
+  AlignedVector<float> replayTime;       // Time along the canonical path
+  AlignedVector<float> replayCapture;    // Time at which the path is captured
+  AlignedVector<float> replayTauOffset;  // Proper time on the path at spawn
+  std::shared_ptr<const TrajectoryTable> trajectoryTable;
+  float minSpeed, maxSpeed;
+  bool replayEnabled;
+
+  // Capture prediction
+  AlignedVector<uint8_t> doomed;         // Certain to be captured: moves straight, skips integration
+  bool capturePrediction;
+
+  // Weak-field coasting: p(t) = p0 + v0 t + a0 t^2 / 2 in frame time, refit every window
+  AlignedVector<uint8_t> coasting;       // Inside a closed-form window
+  AlignedVector<float> coastTime;        // Time since the window was anchored
+  AlignedVector<float> coastWindow;      // Window length allowed by the error bound
+  AlignedVector<float> coastX, coastY;   // Anchor position
+  AlignedVector<float> coastVX, coastVY; // Frame-time velocity at the anchor
+  AlignedVector<float> coastAX, coastAY; // Frame-time acceleration at the anchor
+  AlignedVector<float> coastTau;         // Proper time at the anchor
+  AlignedVector<float> coastTauRate;     // d(proper time)/dt and its derivative at the anchor
+  AlignedVector<float> coastTauAccel;
+  WeakFieldSettings weakField;
+
+  // Fit a closed-form window at the ray's current state; false if it is in the strong field
+  bool BeginCoast(size_t index, const GeodesicStepParams& params);
+  // Leave the window: restore a unit-speed velocity at the current time
+  void EndCoast(size_t index);
+
+  // Kernel parameters for this frame (tuning read from the LightRay statics)
+  GeodesicStepParams MakeStepParams(float deltaTime, glm::vec2 blackholePos,
+    float blackholeMass, float eventHorizon) const;
+
+  // Try to put a freshly reset ray onto the cached path
+  void BeginReplay(size_t index, float dirX, float dirY);
+
+  // Classify a freshly reset ray against the table's capture window
+  bool PredictCapture(size_t index, float dirX, float dirY) const;
+
+  // Respawn queue: a ring holding each ray at most once
+  AlignedVector<uint8_t> respawnPending; // Parked until its respawn is processed
+  AlignedVector<uint32_t> respawnRing;
+  size_t respawnHead;                    // Oldest queued entry
+  size_t respawnCount;
+  size_t respawnBudget;
+  AlignedVector<float> resetDirX, resetDirY;  // Scratch for ResetRays
+  // Rays gathered per reset kernel call: a multiple of every SIMD width, small enough
+  // for the lanes to live on the stack
+  static constexpr size_t RESET_BLOCK = 64;
+
+  // Trails: one fixed-capacity ring per ray, carved out of a shared slab
+  AlignedVector<glm::vec2> trailSlab;
+  AlignedVector<uint32_t> trailHead;     // Slot of the newest point in each ring
+  AlignedVector<uint32_t> trailCount;    // Number of valid points in each ring
+  uint32_t trailCapacity;
+
+  // Append a point as the new trail head, overwriting the oldest when full
+  void PushTrail(size_t index, glm::vec2 point) {
+    uint32_t head = trailHead[index] + 1;
+    if (head == trailCapacity) head = 0;
+    trailSlab[index * trailCapacity + head] = point;
+    trailHead[index] = head;
+    if (trailCount[index] < trailCapacity) trailCount[index]++;
+  }
+
+  // Propagation and reset kernels picked from CPUID at construction
+  SimdLevel simdLevel;
+  GeodesicStepFn stepKernel;
+  RayResetFn resetKernel;
+
+  // Integration scheme for every ray in the batch
+  IntegratorType integrator;
+  IntegratorSettings integratorSettings;
+
+  // Scratch masks reused by Update
+  std::vector<uint8_t> activeMask;
+  std::vector<uint8_t> integrateMask;
+  std::vector<uint8_t> resetMask;        // Marked for respawn by this step's Update
+  std::vector<uint8_t> respawnMask;
+
+  // Reset jitter: counter-based draws keyed by (seed, ray index, generation)
+  uint64_t seed;
+  AlignedVector<uint32_t> resetGeneration;  // Resets so far, per ray
+};
@@ -0,0 +1,58 @@
+#include "RayResetKernel.h"
+#include "RayResetKernelSimd.h"
+#include <cmath>
+
+// Scalar form of SinCosLanes
+static void SinCosScalar(float x, float& sinX, float& cosX) {
+  int32_t quadrant = static_cast<int32_t>(std::nearbyint(x * SINCOS_TWO_OVER_PI));
+  float q = static_cast<float>(quadrant);
+  float y = x - q * SINCOS_PI_OVER_2_A;
+  y = y - q * SINCOS_PI_OVER_2_B;
+  y = y - q * SINCOS_PI_OVER_2_C;
+
+  float z = y * y;
+  float s = ((SINCOS_SIN_1 * z + SINCOS_SIN_2) * z + SINCOS_SIN_3) * z * y + y;
+  float c = ((SINCOS_COS_1 * z + SINCOS_COS_2) * z + SINCOS_COS_3) * z * z - 0.5f * z + 1.0f;
+
+  float sinAbs = (quadrant & 1) ? c : s;
+  float cosAbs = (quadrant & 1) ? s : c;
+  sinX = (quadrant & 2) ? 0.0f - sinAbs : sinAbs;
+  cosX = ((quadrant + 1) & 2) ? 0.0f - cosAbs : cosAbs;
+}
+
+void RayResetScalar(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params) {
+  for (size_t i = begin; i < end; ++i) {
+    RandomBlock noise = Philox4x32(lanes.ray[i], lanes.generation[i], params.stream, 0, params.seed);
+
+    // Start position and launch angle, each with slight noise
+    float px = lanes.startX[i] + noise.Uniform(0, -params.positionJitter, params.positionJitter);
+    float py = lanes.startY[i] + noise.Uniform(1, -params.positionJitter, params.positionJitter);
+    float angle = lanes.launchAngle[i] + noise.Uniform(2, -params.angleJitter, params.angleJitter);
+    float dx, dy;
+    SinCosScalar(angle, dy, dx);
+
+    float vx = lanes.speed[i] * dx;
+    float vy = lanes.speed[i] * dy;
+    lanes.posX[i] = px;
+    lanes.posY[i] = py;
+    lanes.dirX[i] = dx;
+    lanes.dirY[i] = dy;
+    lanes.velX[i] = vx;
+    lanes.velY[i] = vy;
+    lanes.angularMomentum[i] = px * vy - py * vx;  // L = r x v (z-component)
+  }
+}
+
+RayResetFn GetRayResetKernel(SimdLevel level) {
+  switch (ClampSimdLevel(level)) {
+#if defined(OPENGLFW_SIMD_X86)
+  case SimdLevel::SSE41: return RayResetSSE41;
+  case SimdLevel::AVX2: return RayResetAVX2;
+  case SimdLevel::AVX512: return RayResetAVX512;
+#endif
+#if defined(OPENGLFW_SIMD_NEON)
+  case SimdLevel::NEON: return RayResetNEON;
+#endif
+  default: return RayResetScalar;
+  }
+}
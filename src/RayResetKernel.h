@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "GeodesicKernel.h"
+
+// Uniform parameters for one batch of ray resets
+struct RayResetParams {
+  uint64_t seed;           // Philox key
+  uint32_t stream;         // Third counter word (see RandomStream)
+  float positionJitter;    // Start positions move by up to this in x and in y
+  float angleJitter;       // Launch angles turn by up to this (radians)
+};
+
+// Rays being reset, gathered into slots [0, count) of a contiguous block
+struct RayResetLanes {
+  const uint32_t* ray;         // Ray index (first counter word)
+  const uint32_t* generation;  // Reset generation (second counter word)
+  const float* startX;
+  const float* startY;
+  const float* launchAngle;
+  const float* speed;
+  float* posX;                 // Receive the jittered head state
+  float* posY;
+  float* velX;
+  float* velY;
+  float* dirX;                 // Unit launch direction
+  float* dirY;
+  float* angularMomentum;
+};
+
+// Computes the head state of slots [begin, end): each ray's jitter is drawn from
+// Philox4x32(ray, generation, stream, 0, seed), then its position, launch direction (sin
+// and cos by polynomial), velocity and angular momentum follow
+using RayResetFn = void (*)(const RayResetLanes& lanes, size_t begin, size_t end,
+  const RayResetParams& params);
+
+// Scalar reference implementation (same operation order as the vector kernels)
+void RayResetScalar(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params);
+
+// Kernel for a level; unsupported levels fall back to the scalar kernel
+RayResetFn GetRayResetKernel(SimdLevel level);
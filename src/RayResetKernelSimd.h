@@ -0,0 +1,127 @@
+#pragma once
+
+// Width-generic ray reset kernel.
+// Instantiated by the same per-ISA translation units as GeodesicStepSimd, with their
+// vector types. Besides the float lanes listed in GeodesicKernelSimd.h it needs V::U,
+// 32-bit integer lanes:
+//   SetU, LoadU, StoreU, MulWide(a, b, hi, lo) (high and low words of the 64-bit products)
+//   operators + ^ & on U, Nonzero (U -> M), RoundToInt (F -> U, to nearest even)
+//   ToFloat (U read as signed -> F), ToUnit (top 24 bits of U -> F in [0, 1))
+
+#include "CounterRng.h"
+#include "RayResetKernel.h"
+
+#if defined(OPENGLFW_SIMD_X86)
+void RayResetSSE41(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params);
+void RayResetAVX2(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params);
+void RayResetAVX512(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params);
+#endif
+
+#if defined(OPENGLFW_SIMD_NEON)
+void RayResetNEON(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params);
+#endif
+
+// sin/cos by quadrant: x is reduced by the nearest multiple of pi/2 (subtracted in three
+// parts, exact for the few turns a launch angle spans), then minimax polynomials on
+// [-pi/4, pi/4] (Cephes sinf/cosf) give about 2 ulp
+constexpr float SINCOS_TWO_OVER_PI = 0.636619772f;
+constexpr float SINCOS_PI_OVER_2_A = 1.5703125f;
+constexpr float SINCOS_PI_OVER_2_B = 4.837512969970703125e-4f;
+constexpr float SINCOS_PI_OVER_2_C = 7.54978995489188216e-8f;
+constexpr float SINCOS_SIN_1 = -1.9515295891e-4f;
+constexpr float SINCOS_SIN_2 = 8.3321608736e-3f;
+constexpr float SINCOS_SIN_3 = -1.6666654611e-1f;
+constexpr float SINCOS_COS_1 = 2.443315711809948e-5f;
+constexpr float SINCOS_COS_2 = -1.388731625493765e-3f;
+constexpr float SINCOS_COS_3 = 4.166664568298827e-2f;
+
+template <typename V>
+void SinCosLanes(typename V::F x, typename V::F& sinX, typename V::F& cosX) {
+  using F = typename V::F;
+  using U = typename V::U;
+  using M = typename V::M;
+
+  U quadrant = V::RoundToInt(x * V::Set(SINCOS_TWO_OVER_PI));
+  F q = V::ToFloat(quadrant);
+  F y = x - q * V::Set(SINCOS_PI_OVER_2_A);
+  y = y - q * V::Set(SINCOS_PI_OVER_2_B);
+  y = y - q * V::Set(SINCOS_PI_OVER_2_C);
+
+  F z = y * y;
+  F s = ((V::Set(SINCOS_SIN_1) * z + V::Set(SINCOS_SIN_2)) * z + V::Set(SINCOS_SIN_3)) * z * y + y;
+  F c = ((V::Set(SINCOS_COS_1) * z + V::Set(SINCOS_COS_2)) * z + V::Set(SINCOS_COS_3)) * z * z
+    - V::Set(0.5f) * z + V::Set(1.0f);
+
+  // Quadrants 0 to 3: sin is s, c, -s, -c and cos is c, -s, -c, s
+  M swap = V::Nonzero(quadrant & V::SetU(1));
+  M sinNegative = V::Nonzero(quadrant & V::SetU(2));
+  M cosNegative = V::Nonzero((quadrant + V::SetU(1)) & V::SetU(2));
+  F zero = V::Set(0.0f);
+  F sinAbs = V::Select(swap, c, s);
+  F cosAbs = V::Select(swap, s, c);
+  sinX = V::Select(sinNegative, zero - sinAbs, sinAbs);
+  cosX = V::Select(cosNegative, zero - cosAbs, cosAbs);
+}
+
+// Philox4x32-10 of one counter per lane, all under the same key (see CounterRng.h)
+template <typename V>
+void PhiloxLanes(typename V::U counter[4], uint64_t seed) {
+  using U = typename V::U;
+
+  const U m0 = V::SetU(PHILOX_M0);
+  const U m1 = V::SetU(PHILOX_M1);
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+
+  for (int round = 0; round < PHILOX_ROUNDS; round++) {
+    U hi0, lo0, hi1, lo1;
+    V::MulWide(counter[0], m0, hi0, lo0);
+    V::MulWide(counter[2], m1, hi1, lo1);
+    counter[0] = hi1 ^ counter[1] ^ V::SetU(k0);
+    counter[1] = lo1;
+    counter[2] = hi0 ^ counter[3] ^ V::SetU(k1);
+    counter[3] = lo0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+}
+
+template <typename V>
+void RayResetSimd(const RayResetLanes& lanes, size_t begin, size_t end, const RayResetParams& params) {
+  using F = typename V::F;
+  using U = typename V::U;
+
+  const U stream = V::SetU(params.stream);
+  const U zeroU = V::SetU(0);
+  // RandomBlock::Uniform over [-jitter, jitter)
+  const F positionLow = V::Set(-params.positionJitter);
+  const F positionSpan = V::Set(params.positionJitter - -params.positionJitter);
+  const F angleLow = V::Set(-params.angleJitter);
+  const F angleSpan = V::Set(params.angleJitter - -params.angleJitter);
+
+  size_t i = begin;
+  for (; i + V::Width <= end; i += V::Width) {
+    U noise[4] = { V::LoadU(lanes.ray + i), V::LoadU(lanes.generation + i), stream, zeroU };
+    PhiloxLanes<V>(noise, params.seed);
+
+    F px = V::Load(lanes.startX + i) + (positionLow + positionSpan * V::ToUnit(noise[0]));
+    F py = V::Load(lanes.startY + i) + (positionLow + positionSpan * V::ToUnit(noise[1]));
+    F angle = V::Load(lanes.launchAngle + i) + (angleLow + angleSpan * V::ToUnit(noise[2]));
+    F dx, dy;
+    SinCosLanes<V>(angle, dy, dx);
+
+    F speed = V::Load(lanes.speed + i);
+    F vx = speed * dx;
+    F vy = speed * dy;
+    V::Store(lanes.posX + i, px);
+    V::Store(lanes.posY + i, py);
+    V::Store(lanes.dirX + i, dx);
+    V::Store(lanes.dirY + i, dy);
+    V::Store(lanes.velX + i, vx);
+    V::Store(lanes.velY + i, vy);
+    V::Store(lanes.angularMomentum + i, px * vy - py * vx);  // L = r x v (z-component)
+  }
+
+  // Leftover slots
+  RayResetScalar(lanes, i, end, params);
+}
@@ -0,0 +1,36 @@
+#include "SimulationClock.h"
+#include <algorithm>
+
+SimulationClock::SimulationClock(float step, int substeps)
+  : fixedStep(std::max(step, 1e-4f))
+  , maxSubsteps(std::max(substeps, 1))
+  , accumulator(0.0f)
+  , simulatedTime(0.0)
+  , droppedTime(0.0) {
+}
+
+int SimulationClock::Advance(float frameTime) {
+  accumulator += std::max(frameTime, 0.0f);
+
+  int steps = static_cast<int>(accumulator / fixedStep);
+  if (steps > maxSubsteps) {
+    // Render stall: run what the budget allows and forget the rest
+    float excess = (steps - maxSubsteps) * fixedStep;
+    accumulator -= excess;
+    droppedTime += excess;
+    steps = maxSubsteps;
+  }
+
+  accumulator = std::max(accumulator - steps * fixedStep, 0.0f);
+  simulatedTime += steps * static_cast<double>(fixedStep);
+  return steps;
+}
+
+void SimulationClock::SetFixedStep(float step) {
+  fixedStep = std::max(step, 1e-4f);
+  accumulator = std::min(accumulator, fixedStep);
+}
+
+void SimulationClock::SetMaxSubsteps(int count) {
+  maxSubsteps = std::max(count, 1);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// Fixed-timestep simulation clock.
+// Render frames feed wall-clock time into an accumulator that is drained in whole
+// fixed steps, so physics advances by simulated time regardless of the render rate.
+// Time beyond maxSubsteps per frame is dropped, so a stall cannot snowball.
+class SimulationClock {
+public:
+  explicit SimulationClock(float fixedStep = 1.0f / 60.0f, int maxSubsteps = 4);
+
+  // Add one render frame's wall-clock time; returns the number of fixed steps to run now
+  int Advance(float frameTime);
+
+  // Fraction of a step left in the accumulator (blend factor between the last two states)
+  float GetAlpha() const { return accumulator / fixedStep; }
+
+  void SetFixedStep(float step);
+  float GetFixedStep() const { return fixedStep; }
+
+  void SetMaxSubsteps(int count);
+  int GetMaxSubsteps() const { return maxSubsteps; }
+
+  // Totals since construction
+  double GetSimulatedTime() const { return simulatedTime; }
+  double GetDroppedTime() const { return droppedTime; }   // Wall-clock time discarded after stalls
+
+private:
+  float fixedStep;      // Simulation step (seconds)
+  int maxSubsteps;      // Most steps run for one render frame
+  float accumulator;    // Wall-clock time not yet simulated (< fixedStep between frames)
+  double simulatedTime;
+  double droppedTime;
+};
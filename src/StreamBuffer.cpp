@@ -0,0 +1,86 @@
+#include "StreamBuffer.h"
+
+StreamBuffer::StreamBuffer()
+  : target(GL_ARRAY_BUFFER)
+  , buffer(0)
+  , regionSize(0)
+  , regionCount(0)
+  , region(-1)
+  , persistentBase(nullptr) {
+}
+
+StreamBuffer::~StreamBuffer() {
+  for (GLsync fence : fences) {
+    if (fence) glDeleteSync(fence);
+  }
+  if (buffer) glDeleteBuffers(1, &buffer);  // Also ends a persistent mapping
+}
+
+bool StreamBuffer::Initialize(GLenum bufferTarget, size_t bytesPerRegion, int regions) {
+  target = bufferTarget;
+  regionSize = bytesPerRegion;
+  regionCount = regions;
+  region = -1;
+  fences.assign(regionCount, nullptr);
+
+  size_t size = regionSize * regionCount;
+
+  // Clear stale errors, so the check at the end only sees the allocation's
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  glGenBuffers(1, &buffer);
+  glBindBuffer(target, buffer);
+
+  if (GLAD_GL_VERSION_4_4 && glBufferStorage) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(target, size, nullptr, flags);
+    persistentBase = static_cast<char*>(glMapBufferRange(target, 0, size, flags));
+    if (persistentBase) return true;
+
+    // Storage or mapping failed: start again with mutable storage
+    while (glGetError() != GL_NO_ERROR) {
+    }
+    glDeleteBuffers(1, &buffer);
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+  }
+
+  glBufferData(target, size, nullptr, GL_STREAM_DRAW);
+  GLint64 allocated = 0;
+  glGetBufferParameteri64v(target, GL_BUFFER_SIZE, &allocated);
+  return glGetError() == GL_NO_ERROR && allocated == static_cast<GLint64>(size);
+}
+
+void* StreamBuffer::Map(size_t bytes) {
+  if (bytes > regionSize) return nullptr;
+
+  // Everything reading the previous region has been issued: fence it
+  if (persistentBase && region >= 0) {
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+  region = (region + 1) % regionCount;
+  size_t offset = static_cast<size_t>(region) * regionSize;
+  glBindBuffer(target, buffer);
+
+  if (persistentBase) {
+    // Only blocks if the GPU is still reading this region from regionCount frames ago
+    if (GLsync fence = fences[region]) {
+      GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+      glDeleteSync(fence);
+      fences[region] = nullptr;
+      if (result == GL_WAIT_FAILED) return nullptr;  // Cannot tell whether the region is free
+    }
+    return persistentBase + offset;
+  }
+
+  // Back at the start of the ring: orphan the buffer rather than wait for old draws.
+  // Within one lap every region is fresh, so no mapping needs to synchronize.
+  if (region == 0) glBufferData(target, regionSize * regionCount, nullptr, GL_STREAM_DRAW);
+  return glMapBufferRange(target, offset, bytes,
+    GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+size_t StreamBuffer::Unmap() {
+  if (!persistentBase) glUnmapBuffer(target);
+  return static_cast<size_t>(region) * regionSize;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+// Ring of per-frame regions in one GL buffer that the CPU writes directly.
+// Each Map hands out the next region; the data goes straight into GPU-visible memory
+// instead of through a client-side array and a glBufferSubData copy, and the driver never
+// has to stall or shadow the buffer because a draw may still be reading it.
+//   With GL 4.4 buffer storage the buffer is mapped once, persistent and coherent, and a
+//   fence per region keeps the CPU from overwriting a region the GPU has not finished
+//   with (it can only wait when the GPU is regionCount frames behind).
+//   Otherwise regions are mapped unsynchronized, and when the ring wraps the buffer is
+//   orphaned so the driver hands out fresh storage while older draws finish with the old.
+// GL thread only.
+class StreamBuffer {
+public:
+  StreamBuffer();
+  ~StreamBuffer();
+
+  // Create the buffer: regionCount regions of regionSize bytes, for binding to target
+  // (e.g. GL_ARRAY_BUFFER or GL_PIXEL_UNPACK_BUFFER). Leaves the buffer bound to target.
+  // Returns false if the storage could not be allocated.
+  bool Initialize(GLenum target, size_t regionSize, int regionCount = 3);
+
+  unsigned int GetBuffer() const { return buffer; }
+  size_t GetRegionSize() const { return regionSize; }
+  bool IsPersistent() const { return persistentBase != nullptr; }
+
+  // Bind the buffer and return up to regionSize bytes of the next region to write.
+  // Commands reading the previous region must already have been issued.
+  // Returns null (skip this frame's write, and do not Unmap) if the region cannot be had.
+  void* Map(size_t bytes);
+
+  // Finish writing the region from the last Map (the buffer stays bound); returns its
+  // byte offset in the buffer, for the draw or texture upload that reads it
+  size_t Unmap();
+
+private:
+  GLenum target;
+  unsigned int buffer;
+  size_t regionSize;
+  int regionCount;
+  int region;                     // Region of the last Map (-1 before the first)
+  char* persistentBase;           // Whole buffer, mapped for good (null: map per region)
+  std::vector<GLsync> fences;     // Per region: signalled once the GPU is done reading it
+};
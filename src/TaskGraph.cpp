@@ -0,0 +1,110 @@
+#include "TaskGraph.h"
+#include <algorithm>
+#include <chrono>
+
+static double NowMs() {
+  using namespace std::chrono;
+  return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+TaskGraph::TaskGraph()
+  : taskCount(0)
+  , readyHead(0)
+  , finished(0) {
+}
+
+void TaskGraph::Clear() {
+  for (size_t i = 0; i < taskCount; i++) {
+    tasks[i].fn = nullptr;
+    tasks[i].successors.clear();
+  }
+  taskCount = 0;
+}
+
+size_t TaskGraph::FindStage(const char* name) {
+  for (size_t s = 0; s < stages.size(); s++) {
+    if (stages[s].name == name) return s;
+  }
+  stages.push_back({ name, 0, 0.0, 0.0 });
+  return stages.size() - 1;
+}
+
+TaskGraph::TaskId TaskGraph::AddTask(const char* stage, TaskFn fn) {
+  if (taskCount == tasks.size()) tasks.emplace_back();
+  Task& task = tasks[taskCount];
+  task.fn = std::move(fn);
+  task.stage = FindStage(stage);
+  task.dependencies = 0;
+  return taskCount++;
+}
+
+void TaskGraph::AddDependency(TaskId before, TaskId after) {
+  tasks[before].successors.push_back(after);
+  tasks[after].dependencies++;
+}
+
+void TaskGraph::Run(ThreadPool& pool) {
+  for (StageTiming& stage : stages) {
+    stage.tasks = 0;
+    stage.busyMs = 0.0;
+    stage.spanMs = 0.0;
+  }
+  if (taskCount == 0) return;
+
+  // Seed the ready list with the roots, in declaration order
+  ready.resize(taskCount);
+  readyHead = 0;
+  size_t readyTail = 0;
+  for (size_t i = 0; i < taskCount; i++) {
+    tasks[i].waiting = tasks[i].dependencies;
+    if (tasks[i].waiting == 0) ready[readyTail++] = i;
+  }
+  ready.resize(readyTail);
+  finished = 0;
+
+  // Every thread in the pool pulls ready tasks until the graph is done
+  double originMs = NowMs();
+  pool.ParallelFor(0, pool.GetThreadCount(), 1, [&](size_t slot, size_t, size_t) {
+    RunTasks(slot, originMs);
+  });
+
+  // Per-stage totals
+  std::vector<double> firstStart(stages.size(), 0.0), lastEnd(stages.size(), 0.0);
+  for (size_t i = 0; i < taskCount; i++) {
+    const Task& task = tasks[i];
+    StageTiming& stage = stages[task.stage];
+    firstStart[task.stage] = stage.tasks == 0 ? task.startMs : std::min(firstStart[task.stage], task.startMs);
+    lastEnd[task.stage] = std::max(lastEnd[task.stage], task.endMs);
+    stage.tasks++;
+    stage.busyMs += task.endMs - task.startMs;
+  }
+  for (size_t s = 0; s < stages.size(); s++) {
+    if (stages[s].tasks > 0) stages[s].spanMs = lastEnd[s] - firstStart[s];
+  }
+}
+
+void TaskGraph::RunTasks(size_t slot, double originMs) {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    wake.wait(lock, [this] { return readyHead < ready.size() || finished == taskCount; });
+    if (readyHead == ready.size()) return;  // Everything has finished
+
+    Task& task = tasks[ready[readyHead++]];
+    lock.unlock();
+
+    task.startMs = NowMs() - originMs;
+    task.fn(slot);
+    task.endMs = NowMs() - originMs;
+
+    lock.lock();
+    finished++;
+    bool released = false;
+    for (TaskId next : task.successors) {
+      if (--tasks[next].waiting == 0) {
+        ready.push_back(next);
+        released = true;
+      }
+    }
+    if (released || finished == taskCount) wake.notify_all();
+  }
+}
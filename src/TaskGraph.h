@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ThreadPool.h"
+
+// Small dependency-graph scheduler on top of ThreadPool.
+// Tasks are declared with a stage name and explicit "runs after" edges; Run starts
+// every task as soon as its predecessors are done, so independent work from different
+// stages overlaps (e.g. one tile decays while another is still being drawn).
+// Tasks must not call back into the pool. A graph can be Run any number of times, so a
+// fixed workload is built once; Clear keeps the storage, and stages keep their order of
+// first appearance.
+class TaskGraph {
+public:
+  // Body of a task; slot identifies the running thread (see ThreadPool::ParallelFor)
+  using TaskFn = std::function<void(size_t slot)>;
+  using TaskId = size_t;
+
+  // Per-stage figures for the last Run
+  struct StageTiming {
+    std::string name;
+    size_t tasks;        // Tasks run
+    double busyMs;       // Sum of task run times (CPU time spent in the stage)
+    double spanMs;       // First task start to last task end (wall time)
+  };
+
+  TaskGraph();
+
+  // Drop all tasks (stage names and their timings are kept)
+  void Clear();
+
+  TaskId AddTask(const char* stage, TaskFn fn);
+
+  // `after` does not start until `before` has finished
+  void AddDependency(TaskId before, TaskId after);
+
+  // Run every task on the pool; returns when all have finished
+  void Run(ThreadPool& pool);
+
+  const std::vector<StageTiming>& GetStageTimings() const { return stages; }
+
+private:
+  struct Task {
+    TaskFn fn;
+    size_t stage;
+    std::vector<TaskId> successors;
+    int dependencies;    // Number of predecessors
+    int waiting;         // Predecessors not yet finished (during Run)
+    double startMs, endMs;
+  };
+
+  std::vector<Task> tasks;    // First taskCount entries are live; the rest keep their capacity
+  size_t taskCount;
+  std::vector<StageTiming> stages;
+
+  // Run state, guarded by mutex
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<TaskId> ready;  // FIFO of tasks whose predecessors are done
+  size_t readyHead;
+  size_t finished;
+
+  void RunTasks(size_t slot, double originMs);
+  size_t FindStage(const char* name);
+};
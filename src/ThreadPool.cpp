@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+int ThreadPool::HardwareThreads() {
+  unsigned count = std::thread::hardware_concurrency();
+  return count > 0 ? static_cast<int>(count) : 1;
+}
+
+ThreadPool::ThreadPool(int threadCount)
+  : job(nullptr)
+  , jobBegin(0)
+  , jobEnd(0)
+  , jobGrain(1)
+  , jobGeneration(0)
+  , busyWorkers(0)
+  , stopping(false) {
+  Start(threadCount);
+}
+
+ThreadPool::~ThreadPool() {
+  Stop();
+}
+
+void ThreadPool::SetThreadCount(int threadCount) {
+  Stop();
+  Start(threadCount);
+}
+
+void ThreadPool::Start(int threadCount) {
+  if (threadCount <= 0) threadCount = HardwareThreads();
+
+  stopping = false;
+  queues = std::make_unique<ChunkQueue[]>(threadCount);
+  workers.reserve(threadCount - 1);
+  for (int i = 1; i < threadCount; i++) {
+    workers.emplace_back(&ThreadPool::WorkerLoop, this, static_cast<size_t>(i), jobGeneration);
+  }
+}
+
+void ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    stopping = true;
+  }
+  jobReady.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, const RangeFn& body) {
+  ParallelFor(begin, end, grain, SlotRangeFn([&body](size_t, size_t chunkBegin, size_t chunkEnd) {
+    body(chunkBegin, chunkEnd);
+  }));
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, const SlotRangeFn& body) {
+  if (end <= begin) return;
+  grain = std::max<size_t>(grain, 1);
+  size_t chunkCount = (end - begin + grain - 1) / grain;
+
+  // Nothing to share: run inline in chunk order
+  if (workers.empty() || chunkCount == 1) {
+    for (size_t c = 0; c < chunkCount; c++) {
+      size_t chunkBegin = begin + c * grain;
+      body(0, chunkBegin, std::min(end, chunkBegin + grain));
+    }
+    return;
+  }
+
+  // Deal each participant a contiguous run of chunks (neighbouring rays stay on one core)
+  size_t participants = workers.size() + 1;
+  for (size_t p = 0; p < participants; p++) {
+    std::lock_guard<std::mutex> lock(queues[p].mutex);
+    queues[p].front = chunkCount * p / participants;
+    queues[p].back = chunkCount * (p + 1) / participants;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    job = &body;
+    jobBegin = begin;
+    jobEnd = end;
+    jobGrain = grain;
+    busyWorkers = static_cast<int>(workers.size());
+    jobGeneration++;
+  }
+  jobReady.notify_all();
+
+  // The caller works too, then waits for the workers to let go of the job
+  RunChunks(0);
+
+  std::unique_lock<std::mutex> lock(jobMutex);
+  jobDone.wait(lock, [this] { return busyWorkers == 0; });
+  job = nullptr;
+}
+
+void ThreadPool::WorkerLoop(size_t slot, uint64_t seenGeneration) {
+  // seenGeneration is the loop count at start-up, so a loop issued before this
+  // thread first takes the lock is not missed
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(jobMutex);
+      jobReady.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+      if (stopping) return;
+      seenGeneration = jobGeneration;
+    }
+
+    RunChunks(slot);
+
+    {
+      std::lock_guard<std::mutex> lock(jobMutex);
+      busyWorkers--;
+      if (busyWorkers == 0) jobDone.notify_one();
+    }
+  }
+}
+
+void ThreadPool::RunChunks(size_t slot) {
+  size_t chunk;
+  while (TakeFront(slot, chunk) || StealBack(slot, chunk)) {
+    size_t chunkBegin = jobBegin + chunk * jobGrain;
+    (*job)(slot, chunkBegin, std::min(jobEnd, chunkBegin + jobGrain));
+  }
+}
+
+bool ThreadPool::TakeFront(size_t slot, size_t& chunk) {
+  ChunkQueue& queue = queues[slot];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.front == queue.back) return false;
+  chunk = queue.front++;
+  return true;
+}
+
+bool ThreadPool::StealBack(size_t slot, size_t& chunk) {
+  // Visit the other queues starting with our neighbour, so thieves spread out
+  size_t participants = workers.size() + 1;
+  for (size_t k = 1; k < participants; k++) {
+    ChunkQueue& victim = queues[(slot + k) % participants];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (victim.front == victim.back) continue;
+    chunk = --victim.back;
+    return true;
+  }
+  return false;
+}
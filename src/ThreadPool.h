@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool for data-parallel loops.
+// ParallelFor cuts a range into fixed-size chunks and deals each participant (the
+// workers plus the calling thread) a contiguous run of them. A participant that runs
+// out steals single chunks from the back of another's run, so a few expensive chunks
+// (rays near the horizon) do not leave the other cores idle.
+// Chunk boundaries depend only on the range and grain, never on the worker count,
+// so a body that only touches its own chunk gives the same result on any machine.
+class ThreadPool {
+public:
+  // Number of hardware threads (at least 1)
+  static int HardwareThreads();
+
+  // Total threads that run a loop, including the caller (0 = one per hardware thread)
+  explicit ThreadPool(int threadCount = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Restart with a different number of threads (must not be called during a loop)
+  void SetThreadCount(int threadCount);
+  int GetThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+  // Run body(chunkBegin, chunkEnd) over [begin, end) in chunks of grain items.
+  // Blocks until every chunk has run; with one thread the chunks run inline, in order.
+  using RangeFn = std::function<void(size_t begin, size_t end)>;
+  void ParallelFor(size_t begin, size_t end, size_t grain, const RangeFn& body);
+
+  // Same, also passing the slot of the running thread (0 = caller, < GetThreadCount()).
+  // No two chunks run on the same slot at once, so it can index per-thread scratch.
+  using SlotRangeFn = std::function<void(size_t slot, size_t begin, size_t end)>;
+  void ParallelFor(size_t begin, size_t end, size_t grain, const SlotRangeFn& body);
+
+private:
+  // One participant's run of chunk indices: the owner pops the front, thieves the back
+  struct alignas(64) ChunkQueue {
+    std::mutex mutex;
+    size_t front = 0;
+    size_t back = 0;
+  };
+
+  std::vector<std::thread> workers;
+  std::unique_ptr<ChunkQueue[]> queues;   // workers.size() + 1 entries; the caller is slot 0
+
+  // Current loop, published under jobMutex
+  std::mutex jobMutex;
+  std::condition_variable jobReady;
+  std::condition_variable jobDone;
+  const SlotRangeFn* job;
+  size_t jobBegin, jobEnd, jobGrain;
+  uint64_t jobGeneration;
+  int busyWorkers;                        // Workers that have not finished the current loop
+  bool stopping;
+
+  void Start(int threadCount);
+  void Stop();
+  void WorkerLoop(size_t slot, uint64_t seenGeneration);
+
+  // Run chunks from our own queue, then steal until every queue is empty
+  void RunChunks(size_t slot);
+  bool TakeFront(size_t slot, size_t& chunk);
+  bool StealBack(size_t slot, size_t& chunk);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+// Read-only view of one ray's trail stored as a fixed-capacity ring buffer.
+// Indexing is head-relative: view[0] is the newest point, view[size()-1] the oldest.
+class TrailView {
+public:
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = glm::vec2;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const glm::vec2*;
+    using reference = const glm::vec2&;
+
+    Iterator(const TrailView* view, size_t index) : view(view), index(index) {}
+
+    reference operator*() const { return (*view)[index]; }
+    pointer operator->() const { return &(*view)[index]; }
+    Iterator& operator++() { ++index; return *this; }
+    Iterator operator++(int) { Iterator old = *this; ++index; return old; }
+    bool operator==(const Iterator& other) const { return index == other.index; }
+    bool operator!=(const Iterator& other) const { return index != other.index; }
+
+  private:
+    const TrailView* view;
+    size_t index;
+  };
+
+  TrailView(const glm::vec2* storage, uint32_t capacity, uint32_t head, uint32_t count)
+    : storage(storage), capacity(capacity), head(head), count(count) {}
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  // Point i steps behind the head
+  const glm::vec2& operator[](size_t i) const {
+    uint32_t offset = static_cast<uint32_t>(i);
+    return storage[head >= offset ? head - offset : head + capacity - offset];
+  }
+
+  const glm::vec2& front() const { return storage[head]; }
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, count); }
+
+private:
+  const glm::vec2* storage;  // Start of this ray's ring in the shared slab
+  uint32_t capacity;
+  uint32_t head;             // Slot of the newest point
+  uint32_t count;
+};
@@ -0,0 +1,216 @@
+#include "TrajectoryCache.h"
+#include "Integrators.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+std::shared_ptr<const TrajectoryTable> TrajectoryTable::Build(const TrajectoryKey& key) {
+  auto table = std::make_shared<TrajectoryTable>();
+  table->key = key;
+  table->speedSamples = key.maxSpeed - key.minSpeed > 1e-4f ? SPEED_SAMPLES : 1;
+
+  int pathCount = table->speedSamples * IMPACT_SAMPLES;
+  table->samples.resize(static_cast<size_t>(pathCount) * MAX_PATH_SAMPLES);
+  table->lengths.assign(pathCount, 0);
+  table->captureTimes.assign(pathCount, std::numeric_limits<float>::infinity());
+
+  GeodesicStepParams params;
+  params.deltaTime = SAMPLE_INTERVAL / SUBSTEPS;
+  params.blackholeX = 0.0f;
+  params.blackholeY = 0.0f;
+  params.blackholeMass = key.blackholeMass;
+  params.eventHorizon = key.eventHorizon;
+  params.gravityMultiplier = key.gravityMultiplier;
+  params.maxForce = key.maxForce;
+  params.minDistance = key.minDistance;
+
+  for (int s = 0; s < table->speedSamples; s++) {
+    float speed = table->speedSamples > 1
+      ? key.minSpeed + (key.maxSpeed - key.minSpeed) * s / (table->speedSamples - 1)
+      : key.minSpeed;
+
+    for (int b = 0; b < IMPACT_SAMPLES; b++) {
+      float impact = ImpactAt(b);
+
+      // Single-ray state advanced with fixed RK4 sub-steps
+      float posX = START_X, posY = impact;
+      float velX = speed, velY = 0.0f;
+      float angularMomentum = posX * velY - posY * velX;
+      float properTime = 0.0f, absorbTimer = 0.0f, stepSize = 0.0f;
+      uint8_t absorbed = 0, mask = 1;
+      GeodesicStepArrays ray = { &posX, &posY, &velX, &velY, &speed, &angularMomentum,
+        &properTime, &absorbTimer, &absorbed, &mask };
+
+      int path = table->PathIndex(s, b);
+      PathSample* out = &table->samples[static_cast<size_t>(path) * MAX_PATH_SAMPLES];
+      int length = 0;
+      out[length++] = { posX, posY, properTime };
+
+      while (length < MAX_PATH_SAMPLES && !absorbed) {
+        for (int step = 0; step < SUBSTEPS && !absorbed; step++) {
+          IntegrateRays(IntegratorType::RK4, ray, &stepSize, 0, 1, params, IntegratorSettings());
+        }
+        out[length++] = { posX, posY, properTime };
+        if (absorbed) {
+          table->captureTimes[path] = (length - 1) * SAMPLE_INTERVAL;
+        }
+        // Done once it is past the reset radius and heading outward
+        bool outside = posX * posX + posY * posY > EXIT_RADIUS * EXIT_RADIUS;
+        if (outside && posX * velX + posY * velY > 0.0f) break;
+      }
+      table->lengths[path] = length;
+    }
+  }
+
+  table->FindCaptureWindows();
+  return table;
+}
+
+void TrajectoryTable::FindCaptureWindows() {
+  captureLow.assign(speedSamples, 1.0f);
+  captureHigh.assign(speedSamples, -1.0f);
+
+  for (int s = 0; s < speedSamples; s++) {
+    // Walk outward from b = 0 until a run of escaping paths ends the window.
+    // Single escapes inside it are chaotic orbits near the horizon and are ignored.
+    int center = IMPACT_SAMPLES / 2;
+    int lowest = center;
+    int highest = center - 1;
+    for (int b = center - 1, gap = 0; b >= 0 && gap <= CAPTURE_GAP; b--) {
+      if (std::isfinite(captureTimes[PathIndex(s, b)])) { lowest = b; gap = 0; }
+      else gap++;
+    }
+    for (int b = center, gap = 0; b < IMPACT_SAMPLES && gap <= CAPTURE_GAP; b++) {
+      if (std::isfinite(captureTimes[PathIndex(s, b)])) { highest = b; gap = 0; }
+      else gap++;
+    }
+    if (lowest > highest) continue;  // Nothing is captured at this speed
+
+    captureLow[s] = ImpactAt(lowest);
+    captureHigh[s] = ImpactAt(highest);
+  }
+}
+
+bool TrajectoryTable::Locate(float impact, float speed, int& b0, float& fb, int& s0, float& fs) const {
+  float u = (impact + MAX_IMPACT) / (2.0f * MAX_IMPACT) * (IMPACT_SAMPLES - 1);
+  if (!(u >= 0.0f && u <= IMPACT_SAMPLES - 1)) return false;
+  b0 = std::min(static_cast<int>(u), IMPACT_SAMPLES - 2);
+  fb = u - b0;
+
+  if (speedSamples == 1) {
+    if (std::abs(speed - key.minSpeed) > 1e-4f) return false;
+    s0 = 0;
+    fs = 0.0f;
+    return true;
+  }
+
+  float v = (speed - key.minSpeed) / (key.maxSpeed - key.minSpeed) * (speedSamples - 1);
+  if (!(v >= -1e-3f && v <= speedSamples - 1 + 1e-3f)) return false;
+  v = std::clamp(v, 0.0f, static_cast<float>(speedSamples - 1));
+  s0 = std::min(static_cast<int>(v), speedSamples - 2);
+  fs = v - s0;
+  return true;
+}
+
+TrajectoryTable::PathSample TrajectoryTable::SamplePath(int path, float t, glm::vec2* velocity) const {
+  const PathSample* data = &samples[static_cast<size_t>(path) * MAX_PATH_SAMPLES];
+  int last = lengths[path] - 1;
+
+  float k = t / SAMPLE_INTERVAL;
+  int k0 = std::clamp(static_cast<int>(k), 0, std::max(last - 1, 0));
+  int k1 = std::min(k0 + 1, last);
+  float f = std::clamp(k - k0, 0.0f, 1.0f);
+
+  const PathSample& a = data[k0];
+  const PathSample& b = data[k1];
+  if (velocity) {
+    *velocity = glm::vec2(b.x - a.x, b.y - a.y) / SAMPLE_INTERVAL;
+  }
+  return { a.x + (b.x - a.x) * f, a.y + (b.y - a.y) * f,
+    a.properTime + (b.properTime - a.properTime) * f };
+}
+
+bool TrajectoryTable::Lookup(float impact, float speed, float startTime, float& captureTime) const {
+  int b0, s0;
+  float fb, fs;
+  if (!Locate(impact, speed, b0, fb, s0, fs)) return false;
+
+  int s1 = speedSamples > 1 ? s0 + 1 : s0;
+  int paths[4] = { PathIndex(s0, b0), PathIndex(s0, b0 + 1), PathIndex(s1, b0), PathIndex(s1, b0 + 1) };
+  float weights[4] = { (1 - fb) * (1 - fs), fb * (1 - fs), (1 - fb) * fs, fb * fs };
+
+  bool captured = std::isfinite(captureTimes[paths[0]]);
+  captureTime = 0.0f;
+  for (int n = 0; n < 4; n++) {
+    // Neighbours must agree on the outcome and cover the entry time
+    if (std::isfinite(captureTimes[paths[n]]) != captured) return false;
+    if (startTime >= (lengths[paths[n]] - 1) * SAMPLE_INTERVAL) return false;
+    captureTime += weights[n] * captureTimes[paths[n]];
+  }
+  if (!captured) captureTime = std::numeric_limits<float>::infinity();
+  return true;
+}
+
+bool TrajectoryTable::PredictCapture(float impact, float speed) const {
+  int b0, s0;
+  float fb, fs;
+  if (!Locate(impact, speed, b0, fb, s0, fs)) return false;
+
+  int s1 = speedSamples > 1 ? s0 + 1 : s0;
+  float margin = CAPTURE_MARGIN * 2.0f * MAX_IMPACT / (IMPACT_SAMPLES - 1);
+  float low = captureLow[s0] + (captureLow[s1] - captureLow[s0]) * fs + margin;
+  float high = captureHigh[s0] + (captureHigh[s1] - captureHigh[s0]) * fs - margin;
+  return impact > low && impact < high;
+}
+
+void TrajectoryTable::Sample(float impact, float speed, float t, glm::vec2& position,
+  glm::vec2& velocity, float& properTime) const {
+  int b0 = 0, s0 = 0;
+  float fb = 0.0f, fs = 0.0f;
+  Locate(impact, speed, b0, fb, s0, fs);
+
+  int s1 = speedSamples > 1 ? s0 + 1 : s0;
+  int paths[4] = { PathIndex(s0, b0), PathIndex(s0, b0 + 1), PathIndex(s1, b0), PathIndex(s1, b0 + 1) };
+  float weights[4] = { (1 - fb) * (1 - fs), fb * (1 - fs), (1 - fb) * fs, fb * fs };
+
+  position = glm::vec2(0.0f);
+  velocity = glm::vec2(0.0f);
+  properTime = 0.0f;
+  for (int n = 0; n < 4; n++) {
+    glm::vec2 pathVelocity;
+    PathSample sample = SamplePath(paths[n], t, &pathVelocity);
+    position += weights[n] * glm::vec2(sample.x, sample.y);
+    velocity += weights[n] * pathVelocity;
+    properTime += weights[n] * sample.properTime;
+  }
+}
+
+TrajectoryCache::~TrajectoryCache() {
+  if (pending.valid()) pending.wait();
+}
+
+void TrajectoryCache::Request(const TrajectoryKey& key) {
+  // Parameters changed: the current table no longer matches
+  if (!hasRequest || !(key == requestedKey)) {
+    requestedKey = key;
+    hasRequest = true;
+    if (current && !(current->GetKey() == key)) {
+      current.reset();
+    }
+  }
+
+  // Collect a finished build
+  if (pending.valid() &&
+    pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    auto table = pending.get();
+    if (table->GetKey() == requestedKey) {
+      current = table;
+    }
+  }
+
+  // Start a build for the latest key (one at a time)
+  if (!current && !pending.valid()) {
+    pending = std::async(std::launch::async, TrajectoryTable::Build, requestedKey);
+  }
+}
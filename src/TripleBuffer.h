@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer, single-consumer triple buffer.
+// The producer fills Back() and publishes it; the consumer picks up the newest
+// published slot with Acquire() and reads Front(). The three slots rotate through
+// one atomic exchange per side, so neither thread ever waits for the other, and
+// the consumer always sees the latest complete value (older unread ones are dropped).
+template <typename T>
+class TripleBuffer {
+public:
+  TripleBuffer()
+    : middle(1)
+    , front(0)
+    , back(2) {
+  }
+
+  // Set every slot (only while neither side is running)
+  void Fill(const T& value) {
+    for (T& slot : slots) slot = value;
+    middle.store(1);
+    front = 0;
+    back = 2;
+  }
+
+  // Producer: the slot being written, then hand it over
+  T& Back() { return slots[back]; }
+  void Publish() {
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  // Consumer: take the newest published slot, if any arrived since the last call
+  bool Acquire() {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+  const T& Front() const { return slots[front]; }
+
+private:
+  static constexpr uint8_t INDEX_MASK = 0x3;
+  static constexpr uint8_t FRESH = 0x4;   // Middle slot holds a value the consumer has not seen
+
+  T slots[3];
+  std::atomic<uint8_t> middle;            // Slot index in transit, plus the FRESH bit
+  uint8_t front;                          // Owned by the consumer
+  uint8_t back;                           // Owned by the producer
+};
@@ -2,7 +2,7 @@
 #include <iostream>
 #include <chrono>
 
-int main() {
+int main(int argc, char** argv) {
   // Create the black hole simulation app
   BlackholeApp app(1024, 768);
 
@@ -12,6 +12,14 @@ int main() {
     return -1;
   }
 
+  // Any arguments are custom colormap files, cycled after the built-in ones
+  for (int i = 1; i < argc; i++) {
+    if (!app.AddPalette(argv[i])) {
+      std::cerr << "Ignoring colormap " << argv[i] << " (expected 2 to " << MAX_PALETTE_SIZE
+        << " lines of \"r g b\" in [0, 1])" << std::endl;
+    }
+  }
+
   std::cout << "==========================================" << std::endl;
   std::cout << "Black Hole Light Ray Simulation" << std::endl;
   std::cout << "==========================================" << std::endl;
@@ -36,6 +44,17 @@ int main() {
   std::cout << std::endl;
   std::cout << "Other Controls:" << std::endl;
   std::cout << "  SPACE or R: Reset simulation (regenerate rays)" << std::endl;
+  std::cout << "  I: Cycle integrator (Euler, Leapfrog, RK4, RK45)" << std::endl;
+  std::cout << "  T: Toggle trajectory cache replay" << std::endl;
+  std::cout << "  B: Toggle capture prediction (skip doomed rays)" << std::endl;
+  std::cout << "  O: Toggle weak-field fast path" << std::endl;
+  std::cout << "  [/]: Decrease/Increase weak-field SWITCH RADIUS" << std::endl;
+  std::cout << "  ,/.: Decrease/Increase weak-field ERROR BOUND" << std::endl;
+  std::cout << "  L: Toggle light field accumulation (binned by tile / per-thread shards)" << std::endl;
+  std::cout << "  U: Toggle lazy light field decay (decay cells only when written or drawn)" << std::endl;
+  std::cout << "  Y: Toggle path-length weighted light field deposits (anti-aliased)" << std::endl;
+  std::cout << "  TAB: Cycle light field colormap (built-in, then files given on the command line)" << std::endl;
+  std::cout << "  W: Cycle worker threads (1, 2, 4, ... up to one per core)" << std::endl;
   std::cout << "  P: Print current parameters" << std::endl;
   std::cout << "  ESC: Exit" << std::endl;
   std::cout << "==========================================" << std::endl;
@@ -53,10 +72,11 @@ int main() {
     // Process input
     app.ProcessInput(app.GetWindow());
 
-    // Update simulation
+    // Hand the frame time to the simulation thread (it drains this in fixed steps
+    // while we render and wait for vsync)
     app.Update(deltaTime);
 
-    // Render
+    // Render the newest finished frame
     app.Render();
   }
 
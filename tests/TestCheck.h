@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the test executables: every failed CHECK is reported with its
+// location, and main returns TestResult() so ctest sees a non-zero exit code.
+
+inline int& TestFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                                    \
+  do {                                                                      \
+    if (!(condition)) {                                                     \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, \
+        #condition);                                                        \
+      TestFailures()++;                                                     \
+    }                                                                       \
+  } while (0)
+
+inline int TestResult() {
+  if (TestFailures() == 0) {
+    std::printf("All checks passed\n");
+    return 0;
+  }
+  std::fprintf(stderr, "%d check(s) failed\n", TestFailures());
+  return 1;
+}
@@ -0,0 +1,118 @@
+// The hand-off between the GL and simulation threads, under real concurrency:
+// TripleBuffer must never show a torn or stale frame, and CommandQueue must run every
+// command exactly once, in push order per producer, including those pushed before Close.
+#include "CommandQueue.h"
+#include "TripleBuffer.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Big enough that a torn read would mix two frames
+struct Frame {
+  uint32_t sequence = 0;
+  std::vector<uint32_t> cells;
+};
+
+void CheckTripleBuffer() {
+  const uint32_t FRAMES = 100000;
+  const size_t CELLS = 1024;
+
+  TripleBuffer<Frame> buffer;
+  Frame empty;
+  empty.cells.assign(CELLS, 0);
+  buffer.Fill(empty);
+
+  std::thread producer([&] {
+    for (uint32_t n = 1; n <= FRAMES; n++) {
+      Frame& frame = buffer.Back();
+      frame.sequence = n;
+      for (uint32_t& cell : frame.cells) cell = n;
+      buffer.Publish();
+    }
+  });
+
+  // Consumer: every frame it picks up is whole and newer than the last
+  uint32_t last = 0;
+  uint32_t received = 0;
+  bool torn = false;
+  bool stale = false;
+  while (last < FRAMES) {
+    if (!buffer.Acquire()) {
+      std::this_thread::yield();
+      continue;
+    }
+    const Frame& frame = buffer.Front();
+    for (uint32_t cell : frame.cells) torn |= cell != frame.sequence;
+    stale |= frame.sequence <= last;
+    last = frame.sequence;
+    received++;
+  }
+  producer.join();
+
+  std::printf("TripleBuffer: %u of %u frames seen\n", received, FRAMES);
+  CHECK(!torn);
+  CHECK(!stale);
+  CHECK(last == FRAMES);
+  CHECK(!buffer.Acquire());  // Nothing new after the last frame
+}
+
+void CheckCommandQueue() {
+  const int PRODUCERS = 4;
+  const uint32_t COMMANDS = 20000;
+
+  CommandQueue queue;
+  // Written only by the consumer, read after it has been joined
+  std::vector<uint32_t> nextExpected(PRODUCERS, 0);
+  int outOfOrder = 0;
+  int batches = 0;
+
+  std::thread consumer([&] {
+    std::vector<CommandQueue::Command> batch;
+    while (queue.WaitAndDrain(batch)) {
+      batches++;
+      for (CommandQueue::Command& command : batch) command();
+    }
+  });
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < PRODUCERS; p++) {
+    producers.emplace_back([&, p] {
+      for (uint32_t n = 0; n < COMMANDS; n++) {
+        queue.Push([&, p, n] {
+          if (nextExpected[p] != n) outOfOrder++;
+          nextExpected[p] = n + 1;
+        });
+      }
+    });
+  }
+  for (std::thread& producer : producers) producer.join();
+
+  // Commands still pending at Close are run before the consumer stops
+  queue.Push([&] { nextExpected[0]++; });
+  queue.Close();
+  consumer.join();
+
+  std::printf("CommandQueue: %u commands from %d threads in %d batches\n",
+    COMMANDS * PRODUCERS + 1, PRODUCERS, batches);
+  CHECK(outOfOrder == 0);
+  CHECK(nextExpected[0] == COMMANDS + 1);
+  for (int p = 1; p < PRODUCERS; p++) CHECK(nextExpected[p] == COMMANDS);
+
+  // A closed, drained queue stays closed
+  std::vector<CommandQueue::Command> batch;
+  CHECK(!queue.WaitAndDrain(batch));
+  CHECK(batch.empty());
+}
+
+}  // namespace
+
+int main() {
+  CheckTripleBuffer();
+  CheckCommandQueue();
+  return TestResult();
+}
@@ -0,0 +1,146 @@
+// Photon integrators: straight lines far from the hole, and the convergence order of
+// RK4 and RK45 against a fine-step reference on a strongly bent path.
+#include "Integrators.h"
+#include "TestCheck.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Photon {
+  float posX, posY, velX, velY, speed, angularMomentum, properTime, absorbTimer;
+  uint8_t absorbed, mask;
+  float stepSize;
+};
+
+Photon Launch(float x, float y, float dirX, float dirY, float speed) {
+  return { x, y, dirX * speed, dirY * speed, speed, x * dirY * speed - y * dirX * speed,
+    0.0f, 0.0f, 0, 1, 0.0f };
+}
+
+// Advance one photon for duration in steps equal frames
+void Propagate(IntegratorType type, Photon& photon, float duration, int steps,
+  GeodesicStepParams params, const IntegratorSettings& settings) {
+  params.deltaTime = duration / static_cast<float>(steps);
+  GeodesicStepArrays arrays = { &photon.posX, &photon.posY, &photon.velX, &photon.velY, &photon.speed,
+    &photon.angularMomentum, &photon.properTime, &photon.absorbTimer, &photon.absorbed, &photon.mask };
+  for (int i = 0; i < steps; i++) {
+    if (type == IntegratorType::Euler) {
+      GeodesicStepScalar(arrays, 0, 1, params);
+    }
+    else {
+      IntegrateRays(type, arrays, &photon.stepSize, 0, 1, params, settings);
+    }
+  }
+}
+
+float Distance(const Photon& a, const Photon& b) {
+  return std::hypot(a.posX - b.posX, a.posY - b.posY);
+}
+
+GeodesicStepParams HoleParams(float x, float y, float mass) {
+  GeodesicStepParams params;
+  params.deltaTime = 0.0f;
+  params.blackholeX = x;
+  params.blackholeY = y;
+  params.blackholeMass = mass;
+  params.eventHorizon = 2.0f * mass;
+  params.gravityMultiplier = 1.0f;
+  params.maxForce = 100.0f;  // Never reached here: keeps the field smooth
+  params.minDistance = 0.01f;
+  return params;
+}
+
+// A light hole a thousand units away bends nothing measurable: every scheme must
+// reproduce the straight line at constant speed
+void CheckWeakFieldStraightLine() {
+  GeodesicStepParams params = HoleParams(1000.0f, 0.0f, 0.01f);
+  const float DURATION = 4.0f;
+
+  for (IntegratorType type : { IntegratorType::Euler, IntegratorType::Leapfrog, IntegratorType::RK4,
+    IntegratorType::RK45 }) {
+    Photon photon = Launch(-1.0f, 0.5f, 0.6f, 0.8f, 0.5f);
+    Propagate(type, photon, DURATION, 240, params, IntegratorSettings{});
+
+    float expectedX = -1.0f + 0.6f * 0.5f * DURATION;
+    float expectedY = 0.5f + 0.8f * 0.5f * DURATION;
+    float deviation = std::hypot(photon.posX - expectedX, photon.posY - expectedY);
+    float speed = std::hypot(photon.velX, photon.velY);
+    std::printf("%s straight line: deviation %.2e\n", IntegratorName(type), deviation);
+    CHECK(deviation < 1e-4f);
+    CHECK(std::fabs(speed - 0.5f) < 1e-5f);
+    CHECK(photon.absorbed == 0);
+  }
+}
+
+// Observed order of accuracy: least-squares slope of log(error) against log(step)
+// over the step counts whose error is well above float rounding
+float ObservedOrder(IntegratorType type, const Photon& start, float duration,
+  const GeodesicStepParams& params, const IntegratorSettings& settings, const Photon& reference) {
+  const float NOISE_FLOOR = 2e-6f;  // A few times the rounding left in the reference
+  double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+  int points = 0;
+  for (int steps = 1; steps <= 16; steps *= 2) {
+    Photon photon = start;
+    Propagate(type, photon, duration, steps, params, settings);
+    float error = Distance(photon, reference);
+    std::printf("%s %2d steps: error %.2e\n", IntegratorName(type), steps, error);
+    if (error < NOISE_FLOOR) break;
+
+    double x = std::log(duration / steps);
+    double y = std::log(error);
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+    points++;
+  }
+  if (points < 2) return 0.0f;
+  return static_cast<float>((points * sumXY - sumX * sumY) / (points * sumXX - sumX * sumX));
+}
+
+// A photon swinging past the hole at under three Schwarzschild radii
+void CheckConvergenceOrder() {
+  GeodesicStepParams params = HoleParams(0.0f, 0.0f, 0.1f);
+  const Photon start = Launch(-1.0f, 0.5f, 1.0f, 0.0f, 1.0f);
+  const float DURATION = 1.0f;
+
+  Photon reference = start;
+  Propagate(IntegratorType::RK4, reference, DURATION, 1024, params, IntegratorSettings{});
+  CHECK(reference.absorbed == 0);
+
+  float rk4Order = ObservedOrder(IntegratorType::RK4, start, DURATION, params, IntegratorSettings{}, reference);
+  std::printf("RK4 observed order %.2f\n", rk4Order);
+  CHECK(rk4Order > 3.5f);
+
+  // A tolerance nothing can miss accepts every step: one Dormand-Prince step per frame
+  IntegratorSettings fixedStep;
+  fixedStep.tolerance = 1e9f;
+  float rk45Order = ObservedOrder(IntegratorType::RK45, start, DURATION, params, fixedStep, reference);
+  std::printf("RK45 observed order %.2f\n", rk45Order);
+  CHECK(rk45Order > 4.5f);
+
+  // With step control on, a tighter tolerance buys a more accurate path
+  float previousError = 1e9f;
+  for (float tolerance : { 1e-3f, 1e-4f, 1e-5f, 1e-6f }) {
+    IntegratorSettings adaptive;
+    adaptive.tolerance = tolerance;
+    Photon photon = start;
+    Propagate(IntegratorType::RK45, photon, DURATION, 1, params, adaptive);
+    float error = Distance(photon, reference);
+    std::printf("RK45 tolerance %.0e: error %.2e\n", tolerance, error);
+    CHECK(error < 20.0f * tolerance);
+    CHECK(error <= previousError);
+    previousError = error;
+  }
+}
+
+}  // namespace
+
+int main() {
+  CheckWeakFieldStraightLine();
+  CheckConvergenceOrder();
+  return TestResult();
+}
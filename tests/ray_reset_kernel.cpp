@@ -0,0 +1,125 @@
+// Vectorized ray reset kernels against the scalar reference, and the scalar reference
+// against the definitions it replaces: the Philox draws of CounterRng.h, and std::sin
+// and std::cos for the launch direction. The slot count leaves a partial tail for every
+// vector width.
+#include "CounterRng.h"
+#include "RayResetKernel.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct ResetSet {
+  std::vector<uint32_t> ray, generation;
+  std::vector<float> startX, startY, launchAngle, speed;
+  std::vector<float> posX, posY, velX, velY, dirX, dirY, angularMomentum;
+
+  explicit ResetSet(size_t count)
+    : ray(count), generation(count), startX(count), startY(count), launchAngle(count), speed(count)
+    , posX(count), posY(count), velX(count), velY(count), dirX(count), dirY(count), angularMomentum(count) {
+  }
+
+  RayResetLanes Lanes() {
+    return { ray.data(), generation.data(), startX.data(), startY.data(), launchAngle.data(), speed.data(),
+      posX.data(), posY.data(), velX.data(), velY.data(), dirX.data(), dirY.data(), angularMomentum.data() };
+  }
+};
+
+// Scattered ray indices and generations; launch angles over several turns either way
+ResetSet MakeResets(size_t count) {
+  ResetSet resets(count);
+  for (size_t k = 0; k < count; k++) {
+    RandomBlock a = Philox4x32(static_cast<uint32_t>(k), 0, 0, 0, 7);
+    resets.ray[k] = a.word[0];
+    resets.generation[k] = a.word[1] % 1000;
+    resets.startX[k] = a.Uniform(2, -3.0f, 3.0f);
+    resets.startY[k] = a.Uniform(3, -3.0f, 3.0f);
+    RandomBlock b = Philox4x32(static_cast<uint32_t>(k), 1, 0, 0, 7);
+    resets.launchAngle[k] = b.Uniform(0, -20.0f, 20.0f);
+    resets.speed[k] = b.Uniform(1, 0.3f, 1.0f);
+  }
+  return resets;
+}
+
+bool Close(float a, float b) {
+  return std::fabs(a - b) <= 1e-6f * (1.0f + std::fabs(b));
+}
+
+const RayResetParams PARAMS = { 0x0123456789abcdefull, RANDOM_STREAM_RESET, 0.02f, 0.03f };
+
+// The scalar kernel draws exactly the CounterRng jitter, and its sin/cos stay within a
+// few ulp of the standard library's
+void CheckScalarReference(size_t count) {
+  ResetSet resets = MakeResets(count);
+  RayResetScalar(resets.Lanes(), 0, count, PARAMS);
+
+  int wrongDraws = 0;
+  float worstDirection = 0.0f;
+  for (size_t k = 0; k < count; k++) {
+    RandomBlock noise = Philox4x32(resets.ray[k], resets.generation[k], PARAMS.stream, 0, PARAMS.seed);
+    wrongDraws += resets.posX[k] != resets.startX[k] + noise.Uniform(0, -0.02f, 0.02f);
+    wrongDraws += resets.posY[k] != resets.startY[k] + noise.Uniform(1, -0.02f, 0.02f);
+
+    double angle = static_cast<double>(resets.launchAngle[k] + noise.Uniform(2, -0.03f, 0.03f));
+    worstDirection = std::max(worstDirection, static_cast<float>(std::fabs(resets.dirX[k] - std::cos(angle))));
+    worstDirection = std::max(worstDirection, static_cast<float>(std::fabs(resets.dirY[k] - std::sin(angle))));
+  }
+  std::printf("Scalar reset: largest sin/cos error %.2e\n", worstDirection);
+  CHECK(wrongDraws == 0);
+  CHECK(worstDirection < 4e-7f);
+}
+
+bool CheckMatches(const ResetSet& simd, const ResetSet& scalar, size_t begin, size_t end, SimdLevel level) {
+  int mismatches = 0;
+  for (size_t k = begin; k < end; k++) {
+    bool same = simd.posX[k] == scalar.posX[k] && simd.posY[k] == scalar.posY[k]
+      && Close(simd.dirX[k], scalar.dirX[k]) && Close(simd.dirY[k], scalar.dirY[k])
+      && Close(simd.velX[k], scalar.velX[k]) && Close(simd.velY[k], scalar.velY[k])
+      && Close(simd.angularMomentum[k], scalar.angularMomentum[k]);
+    if (!same && mismatches++ < 3) {
+      std::fprintf(stderr, "%s slot %zu: dir (%g, %g) vs (%g, %g)\n", SimdLevelName(level), k,
+        simd.dirX[k], simd.dirY[k], scalar.dirX[k], scalar.dirY[k]);
+    }
+  }
+  CHECK(mismatches == 0);
+  return mismatches == 0;
+}
+
+}  // namespace
+
+int main() {
+  const size_t SLOT_COUNT = 1003;  // Not a multiple of any vector width
+
+  CheckScalarReference(SLOT_COUNT);
+
+  ResetSet scalar = MakeResets(SLOT_COUNT);
+  RayResetScalar(scalar.Lanes(), 0, SLOT_COUNT, PARAMS);
+
+  for (SimdLevel level : { SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON }) {
+    if (ClampSimdLevel(level) != level) {
+      std::printf("%s: not supported here, skipped\n", SimdLevelName(level));
+      continue;
+    }
+    RayResetFn kernel = GetRayResetKernel(level);
+    CHECK(kernel != RayResetScalar);
+
+    ResetSet simd = MakeResets(SLOT_COUNT);
+    kernel(simd.Lanes(), 0, SLOT_COUNT, PARAMS);
+    bool matches = CheckMatches(simd, scalar, 0, SLOT_COUNT, level);
+
+    // A range that starts and ends mid-vector leaves the slots outside it alone
+    ResetSet partial = MakeResets(SLOT_COUNT);
+    kernel(partial.Lanes(), 5, SLOT_COUNT - 7, PARAMS);
+    matches = CheckMatches(partial, scalar, 5, SLOT_COUNT - 7, level) && matches;
+    bool untouched = partial.posX[4] == 0.0f && partial.posX[SLOT_COUNT - 7] == 0.0f;
+    CHECK(untouched);
+    if (matches && untouched) {
+      std::printf("%s: %zu resets match the scalar kernel\n", SimdLevelName(level), SLOT_COUNT);
+    }
+  }
+  return TestResult();
+}